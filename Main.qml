@@ -13,6 +13,46 @@ Window {
 
     required property Monitor monitor
 
+    // while set, the task view browses this frozen snapshot and ingestion continues underneath
+    property Snapshot snapshot: null
+    readonly property real totalEndTime: window.snapshot ? window.snapshot.totalEndTime : window.monitor.totalEndTime
+
+    function formatTime(ns) {
+        if(ns < 1000) {
+            return `${ns.toFixed(0)} nanos`
+        } else if(ns < 1000 * 1000) {
+            return `${(ns / 1000).toFixed(0)} micros`
+        } else if(ns < 1000 * 1000 * 1000) {
+            return `${(ns / 1000 / 1000).toFixed(0)} millis`
+        } else {
+            return `${(ns / 1000 / 1000 / 1000).toFixed(0)} secs`
+        }
+    }
+
+    function formatValue(value, unit) {
+        switch(unit) {
+        case 'B': return window.formatBytes(value)
+        case 'B/s': return `${window.formatBytes(value)}/s`
+        default: return `${value.toFixed(0)} ${unit}`
+        }
+    }
+
+    function formatCounters(counters) {
+        return Object.keys(counters).map(name => `${name}: ${counters[name]}`).join(', ')
+    }
+
+    function formatBytes(bytes) {
+        if(bytes < 1024) {
+            return `${bytes.toFixed(0)} B`
+        } else if(bytes < 1024 * 1024) {
+            return `${(bytes / 1024).toFixed(1)} KiB`
+        } else if(bytes < 1024 * 1024 * 1024) {
+            return `${(bytes / 1024 / 1024).toFixed(1)} MiB`
+        } else {
+            return `${(bytes / 1024 / 1024 / 1024).toFixed(1)} GiB`
+        }
+    }
+
     Item {
         anchors.fill: parent
 
@@ -20,7 +60,7 @@ Window {
             id: mouseArea
             anchors.fill: parent
 
-            property real scaleX: window.width / monitor.totalEndTime
+            property real scaleX: window.width / window.totalEndTime
             property real transX: 0
 
             onWheel: {
@@ -38,6 +78,29 @@ Window {
             ColumnLayout {
                 anchors.left: parent.left
                 anchors.right: parent.right
+                RowLayout {
+                    Button {
+                        text: window.snapshot ? qsTr("Back to live") : qsTr("Freeze")
+                        onClicked: {
+                            if (window.snapshot) {
+                                // stops the monitor from preserving state for it right away
+                                const frozen = window.snapshot
+                                window.snapshot = null
+                                frozen.destroy()
+                            } else {
+                                window.snapshot = window.monitor.snapshot()
+                            }
+                        }
+                    }
+                    Text {
+                        visible: window.snapshot !== null
+                        text: window.snapshot
+                              ? qsTr("frozen at %1 (%2 tasks)")
+                                .arg(window.formatTime(window.snapshot.totalEndTime))
+                                .arg(window.snapshot.taskCount)
+                              : ''
+                    }
+                }
                 Slider {
                     id: durationSlider
 
@@ -52,7 +115,7 @@ Window {
                     Layout.fillWidth: true
                     from: 0
                     value: 0
-                    to: monitor.totalEndTime * durationSlider.value
+                    to: window.totalEndTime * durationSlider.value
                 }
 
                 //Flickable {
@@ -71,20 +134,117 @@ Window {
 
                         x: mouseArea.transX
 
+                        Repeater {
+                            // lanes and reads are aggregated live and are not part of snapshots
+                            model: window.snapshot ? [] : window.monitor.lanes
+
+                            Rectangle {
+                                id: laneDelegate
+                                readonly property Lane lane: modelData
+
+                                implicitWidth: laneLayout.implicitWidth + laneLayout.anchors.leftMargin + laneLayout.anchors.rightMargin
+                                implicitHeight: laneLayout.implicitHeight + laneLayout.anchors.topMargin + laneLayout.anchors.bottomMargin
+
+                                border.width: 1
+                                border.color: "#88000000";
+                                radius: 2
+
+                                ColumnLayout {
+                                    id: laneLayout
+
+                                    anchors.fill: parent
+                                    anchors.margins: 1
+                                    spacing: 0
+
+                                    Text {
+                                        Layout.leftMargin: mouseArea.transX < 0 ? -mouseArea.transX : 0
+                                        text: `${laneDelegate.lane.name} (max: ${window.formatValue(laneDelegate.lane.maxValue, laneDelegate.lane.unit)})`
+                                    }
+                                    Item {
+                                        id: laneContainer
+
+                                        readonly property real xscale: mouseArea.scaleX
+
+                                        implicitWidth: window.totalEndTime * laneContainer.xscale
+                                        implicitHeight: 25
+                                        Repeater {
+                                            model: laneDelegate.lane.samples
+                                            Rectangle {
+                                                id: sampleDelegate
+
+                                                readonly property LaneSample sample: modelData
+
+                                                anchors.bottom: parent.bottom
+                                                x: sampleDelegate.sample.startTime * laneContainer.xscale
+                                                implicitWidth: (sampleDelegate.sample.endTime - sampleDelegate.sample.startTime) * laneContainer.xscale
+                                                implicitHeight: laneDelegate.lane.maxValue > 0
+                                                                ? parent.height * sampleDelegate.sample.value / laneDelegate.lane.maxValue
+                                                                : 0
+                                                color: '#ff4488ff'
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        Repeater {
+                            model: window.snapshot ? [] : window.monitor.ioReads
+
+                            Rectangle {
+                                id: ioDelegate
+                                readonly property IoRead read: modelData
+
+                                implicitWidth: window.totalEndTime * mouseArea.scaleX + 2
+                                implicitHeight: ioText.implicitHeight + 2
+
+                                border.width: 1
+                                border.color: "#88000000";
+                                radius: 2
+
+                                Rectangle {
+                                    anchors.top: parent.top
+                                    anchors.bottom: parent.bottom
+                                    anchors.margins: 1
+                                    x: 1 + ioDelegate.read.startTime * mouseArea.scaleX
+                                    width: ((ioDelegate.read.finished ? ioDelegate.read.endTime : window.totalEndTime)
+                                            - ioDelegate.read.startTime) * mouseArea.scaleX
+                                    color: ioDelegate.read.finished ? '#ff88bbff' : '#ffffaa44'
+                                }
+
+                                Text {
+                                    id: ioText
+
+                                    x: 1 + (mouseArea.transX < 0 ? -mouseArea.transX : 0)
+                                    y: 1
+                                    text: `read ${ioDelegate.read.path}: `
+                                          + `${window.formatBytes(ioDelegate.read.bytesCompleted)} / ${window.formatBytes(ioDelegate.read.bytesRequested)}`
+                                          + (ioDelegate.read.finished
+                                             ? ` in ${window.formatTime(ioDelegate.read.inFlightTime)}`
+                                               + ` (${window.formatBytes(ioDelegate.read.throughput)}/s)`
+                                             : ' in flight')
+                                }
+                            }
+                        }
+
                         Repeater {
                             id: repeater
 
-                            model: window.monitor.tasks
+                            model: window.snapshot ? window.snapshot.tasks : window.monitor.tasks
 
                             Rectangle {
                                 id: taskDelegate
                                 readonly property Task task: modelData
+                                // shared finished tasks point at the live aggregates
+                                readonly property LocationStats stats: window.snapshot
+                                                                       ? window.snapshot.locationStats(taskDelegate.task)
+                                                                       : taskDelegate.task.locationStats
 
                                 implicitWidth: taskLayout.implicitWidth + taskLayout.anchors.leftMargin + taskLayout.anchors.rightMargin
                                 implicitHeight: taskLayout.implicitHeight + taskLayout.anchors.topMargin + taskLayout.anchors.bottomMargin
 
-                                border.width: 1
-                                border.color: "#88000000";
+                                border.width: taskDelegate.task.stalled ? 2 : 1
+                                border.color: taskDelegate.task.stalled ? "#ffff0000" : "#88000000";
                                 radius: 2
 
                                 ColumnLayout {
@@ -94,16 +254,36 @@ Window {
                                     anchors.margins: 1
                                     spacing: 0
 
-                                    Text {
+                                    RowLayout {
                                         Layout.leftMargin: mouseArea.transX < 0 ? -mouseArea.transX : 0
-                                        text: taskDelegate.task.location
+                                        spacing: 12
+
+                                        Text {
+                                            text: taskDelegate.task.location
+                                        }
+                                        Text {
+                                            readonly property LocationStats stats: taskDelegate.stats
+
+                                            visible: taskDelegate.task.frameSize > 0
+                                            color: '#ff884400'
+                                            text: `frame: ${window.formatBytes(taskDelegate.task.frameSize)}`
+                                                  + ` (location live: ${stats.liveFrames} / ${window.formatBytes(stats.liveBytes)}`
+                                                  + `, peak: ${window.formatBytes(stats.peakBytes)})`
+                                        }
+                                        Text {
+                                            readonly property var counters: taskDelegate.stats.counters
+
+                                            visible: Object.keys(counters).length > 0
+                                            color: '#ff0044aa'
+                                            text: `location counters: ${window.formatCounters(counters)}`
+                                        }
                                     }
                                     Item {
                                         id: container
 
                                         readonly property real xscale: mouseArea.scaleX
 
-                                        implicitWidth: monitor.totalEndTime * container.xscale
+                                        implicitWidth: window.totalEndTime * container.xscale
                                         implicitHeight: 25
                                         Repeater {
                                             model: taskDelegate.task.log
@@ -120,6 +300,8 @@ Window {
                                                                  : (logDelegate.item.endTime - logDelegate.item.startTime) * container.xscale
                                                 implicitHeight: logText.implicitHeight
                                                 clip: true
+                                                border.width: logDelegate.item.stalled ? 2 : 0
+                                                border.color: '#ffff0000'
                                                 color: {
                                                     switch(logDelegate.item.state) {
                                                     case LogItem.Started: return '#ffaaaaaa'
@@ -144,18 +326,6 @@ Window {
                                                 Text {
                                                     id: logText
 
-                                                    function formatTime(ns) {
-                                                        if(ns < 1000) {
-                                                            return `${ns.toFixed(0)} nanos`
-                                                        } else if(ns < 1000 * 1000) {
-                                                            return `${(ns / 1000).toFixed(0)} micros`
-                                                        } else if(ns < 1000 * 1000 * 1000) {
-                                                            return `${(ns / 1000 / 1000).toFixed(0)} millis`
-                                                        } else {
-                                                            return `${(ns / 1000 / 1000 / 1000).toFixed(0)} secs`
-                                                        }
-                                                    }
-
                                                     color: logDelegate.item.state === LogItem.Finished ? '#ffffff' : '#000000'
 
                                                     text: (() => {
@@ -166,10 +336,19 @@ Window {
                                                                    case LogItem.Finished: return 'finished'
                                                                }
                                                            })()
-                                                          + ` ${logText.formatTime(logDelegate.item.endTime - logDelegate.item.startTime)}`
+                                                          + ` ${window.formatTime(logDelegate.item.endTime - logDelegate.item.startTime)}`
+                                                          + (logDelegate.item.hasCpuTime
+                                                             ? ` (cpu: ${window.formatTime(logDelegate.item.cpuTime)}`
+                                                               + `, off-cpu: ${window.formatTime(logDelegate.item.offCpuTime)})`
+                                                             : '')
+                                                          + (logDelegate.item.hasCounters
+                                                             ? ` (${window.formatCounters(logDelegate.item.counters)})`
+                                                             : '')
                                                           + (logDelegate.item.state === LogItem.Finished
-                                                             ? ` (total: ${logText.formatTime(taskDelegate.task.endTime - taskDelegate.task.startTime)}`
-                                                               + `, work time: ${logText.formatTime(taskDelegate.task.workTime)})`
+                                                             ? ` (total: ${window.formatTime(taskDelegate.task.endTime - taskDelegate.task.startTime)}`
+                                                               + `, work time: ${window.formatTime(taskDelegate.task.workTime)}`
+                                                               + `, cpu: ${window.formatTime(taskDelegate.task.cpuTime)}`
+                                                               + `, off-cpu: ${window.formatTime(taskDelegate.task.offCpuTime)})`
                                                              : '')
                                                 }
 
@@ -0,0 +1,105 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Window
+import QtQuick.Layouts
+import coschedula_monitor 1.0
+
+Window {
+    id: window
+    width: 1040
+    height: 480
+    visible: true
+    title: qsTr("Summary diff")
+
+    required property SummaryDiff diff
+
+    function formatTime(ns) {
+        if(ns < 1000) {
+            return `${ns.toFixed(0)} nanos`
+        } else if(ns < 1000 * 1000) {
+            return `${(ns / 1000).toFixed(1)} micros`
+        } else if(ns < 1000 * 1000 * 1000) {
+            return `${(ns / 1000 / 1000).toFixed(1)} millis`
+        } else {
+            return `${(ns / 1000 / 1000 / 1000).toFixed(2)} secs`
+        }
+    }
+
+    function formatChange(change) {
+        return `${change > 0 ? '+' : ''}${(change * 100).toFixed(1)}%`
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        anchors.margins: 4
+
+        Text {
+            text: qsTr("%1 regression(s) above %2, significant changes first, ranked from slowest to fastest")
+                  .arg(window.diff.regressionCount)
+                  .arg(window.formatChange(window.diff.threshold))
+        }
+
+        ListView {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            spacing: 1
+            model: window.diff.entries
+
+            delegate: Rectangle {
+                id: entryDelegate
+                readonly property SummaryDiffEntry entry: modelData
+
+                width: ListView.view.width
+                implicitHeight: entryLayout.implicitHeight + 2
+                border.width: 1
+                border.color: "#88000000"
+                radius: 2
+                color: !entryDelegate.entry.significant ? '#ffffffff'
+                       : entryDelegate.entry.regression ? '#ffff8888'
+                       : entryDelegate.entry.change > 0 ? '#ffffdd88'
+                       : '#ff88ff88'
+
+                RowLayout {
+                    id: entryLayout
+
+                    anchors.fill: parent
+                    anchors.margins: 1
+                    spacing: 12
+
+                    Text {
+                        Layout.preferredWidth: 60
+                        horizontalAlignment: Text.AlignRight
+                        font.bold: entryDelegate.entry.significant
+                        text: window.formatChange(entryDelegate.entry.change)
+                    }
+                    Text {
+                        Layout.preferredWidth: 90
+                        text: entryDelegate.entry.metric
+                    }
+                    Text {
+                        Layout.preferredWidth: 480
+                        text: `mean: ${window.formatTime(entryDelegate.entry.baselineMean)} -> ${window.formatTime(entryDelegate.entry.candidateMean)}`
+                              + `, p50: ${window.formatTime(entryDelegate.entry.baselineP50)} -> ${window.formatTime(entryDelegate.entry.candidateP50)}`
+                              + `, p90: ${window.formatTime(entryDelegate.entry.baselineP90)} -> ${window.formatTime(entryDelegate.entry.candidateP90)}`
+                              + ` (n: ${entryDelegate.entry.baselineCount} -> ${entryDelegate.entry.candidateCount})`
+                    }
+                    Text {
+                        Layout.fillWidth: true
+                        elide: Text.ElideRight
+                        text: entryDelegate.entry.location
+                    }
+                }
+            }
+        }
+
+        Text {
+            visible: window.diff.addedLocations.length > 0
+            text: qsTr("only in candidate: %1").arg(window.diff.addedLocations.join(', '))
+        }
+        Text {
+            visible: window.diff.removedLocations.length > 0
+            text: qsTr("only in baseline: %1").arg(window.diff.removedLocations.join(', '))
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief The ChunkedLog class - append-only log split into fixed size chunks.
+ * Chunks are shared between the log and its snapshots, an item is never modified once appended,
+ * so a snapshot is just the chunks and the size at the time it was taken. Taking one costs one
+ * reference per chunk and no item is ever copied. Reading it needs no lock against the single
+ * writer: the writer only touches items past every snapshot's size and publishes new items with
+ * a release store.
+ */
+template<typename T, std::size_t ChunkSize = 4096>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class ChunkedLog
+{
+    using Chunk = std::array<T, ChunkSize>;
+
+public:
+    class Snapshot
+    {
+        friend ChunkedLog;
+
+    public:
+        Snapshot() = default;
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const T &at(std::size_t i) const
+        {
+            assert(i < m_size);
+            return (*m_chunks[i / ChunkSize])[i % ChunkSize];
+        }
+
+        /**
+         * @brief forEach - call `f(const T &)` for every item in append order
+         */
+        template<typename F>
+        void forEach(F &&f) const
+        {
+            for (std::size_t i = 0; i < m_size; ++i) {
+                f(at(i));
+            }
+        }
+
+    private:
+        Snapshot(const std::vector<std::shared_ptr<Chunk>> &chunks, std::size_t size)
+            : m_chunks(chunks.begin(), chunks.end())
+            , m_size(size)
+        {}
+
+    private:
+        std::vector<std::shared_ptr<const Chunk>> m_chunks;
+        std::size_t m_size = 0;
+    };
+
+    std::size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+    const T &at(std::size_t i) const
+    {
+        assert(i < size());
+        return (*m_chunks[i / ChunkSize])[i % ChunkSize];
+    }
+
+    void append(const T &item)
+    {
+        const auto size = m_size.load(std::memory_order_relaxed);
+        if (size == m_chunks.size() * ChunkSize) {
+            // full chunks stay alive as long as any snapshot refers to them
+            m_chunks.push_back(std::make_shared<Chunk>());
+        }
+        (*m_chunks.back())[size % ChunkSize] = item;
+        m_size.store(size + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief snapshot - frozen view of the items appended so far, O(size / ChunkSize).
+     * Has to be taken on the writer's thread, the snapshot itself may then be read from any thread.
+     */
+    Snapshot snapshot() const
+    {
+        const auto size = m_size.load(std::memory_order_acquire);
+        return Snapshot(m_chunks, size);
+    }
+
+private:
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    std::atomic<std::size_t> m_size = 0;
+};
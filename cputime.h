@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+/**
+ * @brief The ThreadCpuSample struct - reading of the calling thread's CPU clock.
+ * Two samples are only comparable if they were taken on the same thread.
+ */
+struct ThreadCpuSample
+{
+    std::size_t thread = 0;
+    std::uint64_t ns = 0;
+
+    /**
+     * @brief now - sample `CLOCK_THREAD_CPUTIME_ID`, nullopt where it is not available
+     */
+    static std::optional<ThreadCpuSample> now()
+    {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+        timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+            return std::nullopt;
+        return ThreadCpuSample{std::hash<std::thread::id>{}(std::this_thread::get_id()),
+                               std::uint64_t(ts.tv_sec) * 1000 * 1000 * 1000 + std::uint64_t(ts.tv_nsec)};
+#else
+        return std::nullopt;
+#endif
+    }
+};
@@ -0,0 +1,19 @@
+#include "duration.h"
+
+#include <QRegularExpression>
+
+std::optional<std::chrono::nanoseconds> parseDuration(const QString &str)
+{
+    static const QRegularExpression re(QStringLiteral("^(\\d+(?:\\.\\d+)?)(ns|us|ms|s)$"));
+    const auto match = re.match(str.trimmed());
+    if (!match.hasMatch())
+        return std::nullopt;
+
+    const auto value = match.captured(1).toDouble();
+    const auto unit = match.captured(2);
+    const double factor = unit == QStringLiteral("ns")   ? 1
+                          : unit == QStringLiteral("us") ? 1e3
+                          : unit == QStringLiteral("ms") ? 1e6
+                                                         : 1e9;
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(value * factor));
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <QString>
+#include <chrono>
+#include <optional>
+
+/**
+ * @brief parseDuration - parse durations like `500ns`, `20us`, `1.5ms` or `2s`
+ */
+std::optional<std::chrono::nanoseconds> parseDuration(const QString &str);
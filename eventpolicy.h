@@ -0,0 +1,219 @@
+#pragma once
+
+#include "cputime.h"
+#include "perfcounters.h"
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <coschedula/scheduler.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+/**
+ * Compile-time configuration of `MonitorImpl`. A policy is a type with
+ *  - `static constexpr bool started, suspended, resumed, finished` - which events are recorded,
+ *  - `static constexpr bool locations` - whether `PolicyEvent::location` is captured,
+ *  - `static constexpr bool timestamps` - whether `PolicyEvent::time` is taken,
+ *  - `static constexpr bool threadSamples` - whether resume, suspend and finish events carry `PolicyEvent::thread`,
+ *  - `using Sink = ...` - where events go, see `EventSink`.
+ * Disabled events leave the subscriber callback empty, disabled fields are empty members.
+ * Nothing here depends on Qt, so `MonitorImpl` with a sink like `CounterSink` can be used in
+ * binaries which do not link it.
+ */
+
+enum class EventKind { Started, Suspended, Resumed, Finished };
+
+template<int>
+struct NoEventField
+{};
+
+/**
+ * @brief The ThreadSample struct - clocks of the thread at either end of a resumed slice.
+ * The CPU clock is read right before `PolicyEvent::time` at both ends, so the CPU and the wall
+ * window of a slice cover the same span. Perf counters are only read at the end of a slice, the
+ * sink reads them at its start once its own bookkeeping is done.
+ */
+struct ThreadSample
+{
+    std::optional<ThreadCpuSample> cpu;
+    std::optional<perfcounters::Sample> perf;
+
+    static ThreadSample now() { return {ThreadCpuSample::now(), perfcounters::now()}; }
+};
+
+template<typename Policy>
+struct PolicyEvent
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    const coschedula::scheduler::task_info &info;
+    [[no_unique_address]] std::conditional_t<Policy::timestamps, Clock::time_point, NoEventField<0>> time;
+    [[no_unique_address]] std::conditional_t<Policy::locations, const char *, NoEventField<1>> location;
+    [[no_unique_address]] std::conditional_t<Policy::threadSamples, ThreadSample, NoEventField<2>> thread;
+};
+
+/**
+ * @brief EventSink - `S` handles every event `Policy` enables
+ */
+template<typename S, typename Policy>
+concept EventSink = requires(S &sink, const PolicyEvent<Policy> &event) {
+    requires !Policy::started || requires { sink.onStarted(event); };
+    requires !Policy::suspended || requires { sink.onSuspended(event); };
+    requires !Policy::resumed || requires { sink.onResumed(event); };
+    requires !Policy::finished || requires { sink.onFinished(event); };
+};
+
+/**
+ * @brief sinkAccepts - whether `S` works with `Policy`. A sink needing some events or fields
+ * declares `template<typename Policy> static constexpr bool accepts`.
+ */
+template<typename S, typename Policy>
+constexpr bool sinkAccepts()
+{
+    if constexpr (requires { S::template accepts<Policy>; }) {
+        return S::template accepts<Policy>;
+    } else {
+        return true;
+    }
+}
+
+/**
+ * @brief The MonitorImpl class - subscriber of the scheduler `T` which captures what `Policy` asks
+ * for and hands it to `Policy::Sink`, which it derives from
+ */
+template<std::derived_from<coschedula::scheduler> T, typename Policy>
+    requires EventSink<typename Policy::Sink, Policy>
+class MonitorImpl : public Policy::Sink, public coschedula::scheduler::subscriber
+{
+    using Event = PolicyEvent<Policy>;
+
+    static_assert(sinkAccepts<typename Policy::Sink, Policy>(),
+                  "the sink does not work with this policy, see its `accepts`");
+
+public:
+    template<typename... Args>
+    MonitorImpl(Args &&...args)
+        : Policy::Sink(std::forward<Args>(args)...)
+    {
+        coschedula::scheduler::instance<T>.install_subscriber(*this);
+    }
+
+    // subscriber interface
+public:
+    void task_started(const coschedula::scheduler::task_info &info) override
+    {
+        if constexpr (Policy::started) {
+            this->onStarted(makeEvent<EventKind::Started>(info));
+        }
+    }
+
+    void task_finished(const coschedula::scheduler::task_info &info) override
+    {
+        if constexpr (Policy::finished) {
+            this->onFinished(makeEvent<EventKind::Finished>(info));
+        }
+    }
+
+    void task_suspended(const coschedula::scheduler::task_info &info) override
+    {
+        if constexpr (Policy::suspended) {
+            this->onSuspended(makeEvent<EventKind::Suspended>(info));
+        }
+    }
+
+    void task_resumed(const coschedula::scheduler::task_info &info) override
+    {
+        if constexpr (Policy::resumed) {
+            this->onResumed(makeEvent<EventKind::Resumed>(info));
+        }
+    }
+
+private:
+    /**
+     * @brief makeEvent - capture what the policy asks for, thread samples before the timestamp
+     */
+    template<EventKind Kind>
+    static Event makeEvent(const coschedula::scheduler::task_info &info)
+    {
+        Event result{info, {}, {}, {}};
+        if constexpr (Policy::threadSamples && Kind == EventKind::Resumed) {
+            result.thread.cpu = ThreadCpuSample::now();
+        } else if constexpr (Policy::threadSamples && Kind != EventKind::Started) {
+            result.thread = ThreadSample::now();
+        }
+        if constexpr (Policy::timestamps) {
+            result.time = Event::Clock::now();
+        }
+        if constexpr (Policy::locations) {
+            result.location = info.loc.function_name();
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief The CounterSink class - counts events by kind and nothing else.
+ * Counters are relaxed atomics so they can be read from any thread. Subscribers are only called
+ * from the scheduler thread, so the single writer increments with a plain load and store instead
+ * of a locked read-modify-write.
+ */
+class CounterSink
+{
+public:
+    std::uint64_t count(EventKind kind) const
+    {
+        return m_counts[std::size_t(kind)].load(std::memory_order_relaxed);
+    }
+
+    template<typename E>
+    void onStarted(const E &)
+    {
+        increment(EventKind::Started);
+    }
+
+    template<typename E>
+    void onSuspended(const E &)
+    {
+        increment(EventKind::Suspended);
+    }
+
+    template<typename E>
+    void onResumed(const E &)
+    {
+        increment(EventKind::Resumed);
+    }
+
+    template<typename E>
+    void onFinished(const E &)
+    {
+        increment(EventKind::Finished);
+    }
+
+private:
+    void increment(EventKind kind)
+    {
+        auto &counter = m_counts[std::size_t(kind)];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> m_counts[4] = {};
+};
+
+/**
+ * @brief The CountersPolicy struct - every event counted, no locations, no timestamps
+ */
+struct CountersPolicy
+{
+    static constexpr bool started = true;
+    static constexpr bool suspended = true;
+    static constexpr bool resumed = true;
+    static constexpr bool finished = true;
+    static constexpr bool locations = false;
+    static constexpr bool timestamps = false;
+    static constexpr bool threadSamples = false;
+    using Sink = CounterSink;
+};
@@ -0,0 +1,182 @@
+#include "frameallocator.h"
+
+#ifdef COSCHEDULA_MONITOR_FRAME_ACCOUNTING
+
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief The MallocAllocator struct - keeps the size table from recursing into the replaced `operator new`
+ */
+template<typename T>
+struct MallocAllocator
+{
+    using value_type = T;
+
+    MallocAllocator() = default;
+
+    template<typename U>
+    MallocAllocator(const MallocAllocator<U> &)
+    {}
+
+    T *allocate(std::size_t n)
+    {
+        if (void *const ptr = std::malloc(n * sizeof(T)))
+            return static_cast<T *>(ptr);
+        throw std::bad_alloc();
+    }
+
+    void deallocate(T *ptr, std::size_t) { std::free(ptr); }
+
+    template<typename U>
+    bool operator==(const MallocAllocator<U> &) const
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief The SizeTable struct - size of every live block, keyed by the address returned to the caller
+ */
+struct SizeTable
+{
+    std::mutex mutex;
+    std::unordered_map<const void *,
+                       std::size_t,
+                       std::hash<const void *>,
+                       std::equal_to<const void *>,
+                       MallocAllocator<std::pair<const void *const, std::size_t>>>
+        sizes;
+};
+
+SizeTable &sizeTable()
+{
+    // never destroyed, blocks are still freed during static destruction
+    alignas(SizeTable) static unsigned char storage[sizeof(SizeTable)];
+    static SizeTable *const table = new (storage) SizeTable;
+    return *table;
+}
+
+void *allocate(std::size_t size) noexcept
+{
+    void *const ptr = std::malloc(size > 0 ? size : 1);
+    if (!ptr)
+        return nullptr;
+
+    SizeTable &table = sizeTable();
+    try {
+        const std::lock_guard lock(table.mutex);
+        table.sizes.emplace(ptr, size);
+    } catch (...) {
+        std::free(ptr);
+        return nullptr;
+    }
+    return ptr;
+}
+
+void *allocateOrThrow(std::size_t size)
+{
+    while (true) {
+        if (void *const ptr = allocate(size))
+            return ptr;
+
+        const auto handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void deallocate(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+
+    SizeTable &table = sizeTable();
+    {
+        const std::lock_guard lock(table.mutex);
+        table.sizes.erase(ptr);
+    }
+    std::free(ptr);
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    deallocate(ptr);
+}
+
+std::optional<std::size_t> frameallocator::frameSize(std::coroutine_handle<> handle)
+{
+    if (!handle)
+        return std::nullopt;
+
+    // only blocks handed out by the replaced `operator new` are in the table, so frames from a
+    // promise specific or over-aligned `operator new`, or elided onto the stack, are never read
+    SizeTable &table = sizeTable();
+    const std::lock_guard lock(table.mutex);
+    const auto it = table.sizes.find(handle.address());
+    if (it == table.sizes.end())
+        return std::nullopt;
+    return it->second;
+}
+
+#else
+
+std::optional<std::size_t> frameallocator::frameSize(std::coroutine_handle<>)
+{
+    return std::nullopt;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+
+/**
+ * Opt-in coroutine frame accounting, enabled with `-DENABLE_FRAME_ACCOUNTING=ON`.
+ * It replaces the global (non over-aligned) `operator new`/`operator delete` with versions
+ * which record the requested size of every live block in a side table keyed by its address.
+ * Coroutine frames allocated with that `operator new` start at `handle.address()`, so the size
+ * of a frame is a single lookup when the task is reported to the monitor. Frames allocated
+ * any other way are simply not found. Every allocation pays a locked hash table update.
+ */
+namespace frameallocator {
+
+#ifdef COSCHEDULA_MONITOR_FRAME_ACCOUNTING
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+/**
+ * @brief frameSize - size of the coroutine frame behind `handle`
+ * @return nullopt if accounting is disabled or the frame was not allocated by the replaced `operator new`
+ */
+std::optional<std::size_t> frameSize(std::coroutine_handle<> handle);
+
+} // namespace frameallocator
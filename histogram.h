@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The Histogram class - durations in ns counted into fixed 1-2.5-5 buckets from 1 micro to 10 secs.
+ * Bucket `i` counts observations `<= bounds()[i]`, the last bucket counts everything above.
+ * The exact sum and sum of squares are kept next to the buckets, the mean and variance do not
+ * depend on the bucket resolution.
+ */
+class Histogram
+{
+public:
+    static constexpr std::size_t BoundCount = 22;
+    using Bounds = std::array<std::uint64_t, BoundCount>;
+
+    static constexpr Bounds bounds()
+    {
+        Bounds result{};
+        std::uint64_t decade = 1000;
+        for (std::size_t i = 0; i < BoundCount; decade *= 10) {
+            result[i++] = decade;
+            if (i < BoundCount)
+                result[i++] = decade * 5 / 2;
+            if (i < BoundCount)
+                result[i++] = decade * 5;
+        }
+        return result;
+    }
+
+    void observe(std::uint64_t ns)
+    {
+        constexpr auto b = bounds();
+        std::size_t i = 0;
+        while (i < BoundCount && ns > b[i]) {
+            ++i;
+        }
+        ++m_buckets[i];
+        ++m_count;
+        m_sum += ns;
+        m_sumOfSquares += double(ns) * double(ns);
+    }
+
+    /**
+     * @brief bucket - number of observations in bucket `i` (not cumulative)
+     */
+    std::uint64_t bucket(std::size_t i) const { return m_buckets[i]; }
+    std::uint64_t count() const { return m_count; }
+    std::uint64_t sum() const { return m_sum; }
+
+    double mean() const { return m_count > 0 ? double(m_sum) / double(m_count) : 0; }
+
+    /**
+     * @brief variance - sample variance, zero with fewer than two observations
+     */
+    double variance() const
+    {
+        if (m_count < 2)
+            return 0;
+        const double n = double(m_count);
+        return std::max(0.0, (m_sumOfSquares - mean() * double(m_sum)) / (n - 1));
+    }
+
+    /**
+     * @brief quantile - upper bound estimate of quantile `q` in [0, 1] with linear
+     * interpolation inside the bucket, zero if empty
+     */
+    double quantile(double q) const
+    {
+        if (m_count == 0)
+            return 0;
+
+        constexpr auto b = bounds();
+        const double rank = q * double(m_count);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BoundCount; ++i) {
+            if (m_buckets[i] > 0 && double(seen + m_buckets[i]) >= rank) {
+                const double lower = i == 0 ? 0 : double(b[i - 1]);
+                const double fraction = (rank - double(seen)) / double(m_buckets[i]);
+                return lower + (double(b[i]) - lower) * fraction;
+            }
+            seen += m_buckets[i];
+        }
+        return double(b[BoundCount - 1]);
+    }
+
+private:
+    std::array<std::uint64_t, BoundCount + 1> m_buckets{};
+    std::uint64_t m_count = 0;
+    std::uint64_t m_sum = 0;
+    double m_sumOfSquares = 0;
+};
@@ -0,0 +1,32 @@
+#include "ioitem.h"
+
+IoRead::IoRead(const QString &path,
+               quint64 bytesRequested,
+               TimePoint startTime,
+               QObject *parent)
+    : QObject(parent)
+    , m_path(path)
+    , m_bytesRequested(bytesRequested)
+    , m_startTime(startTime)
+    , m_endTime(startTime)
+{}
+
+qreal IoRead::throughput() const
+{
+    const auto duration = inFlightTime();
+    if (!m_finished || duration == 0)
+        return 0;
+
+    return qreal(m_bytesCompleted) * 1e9 / qreal(duration);
+}
+
+void IoRead::finish(quint64 bytesCompleted, TimePoint time)
+{
+    if (m_finished)
+        return;
+
+    m_bytesCompleted = bytesCompleted;
+    setEndTime(time);
+    m_finished = true;
+    emit finishedChanged();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "logitem.h"
+
+#include <QObject>
+#include <QtQmlIntegration>
+
+/**
+ * @brief The IoRead class - one read issued through `monitored::fs::read`
+ */
+class IoRead : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created by Monitor only")
+
+    Q_PROPERTY(QString path READ path CONSTANT)
+    Q_PROPERTY(quint64 bytesRequested READ bytesRequested CONSTANT)
+    Q_PROPERTY(quint64 bytesCompleted READ bytesCompleted NOTIFY finishedChanged)
+    Q_PROPERTY(bool finished READ finished NOTIFY finishedChanged)
+    Q_PROPERTY(quint64 startTime READ startTimeNs CONSTANT)
+    Q_PROPERTY(quint64 endTime READ endTimeNs NOTIFY endTimeChanged)
+    Q_PROPERTY(quint64 inFlightTime READ inFlightTime NOTIFY endTimeChanged)
+    Q_PROPERTY(qreal throughput READ throughput NOTIFY finishedChanged)
+public:
+    IoRead(const QString &path,
+           quint64 bytesRequested,
+           TimePoint startTime,
+           QObject *parent = nullptr);
+
+    QString path() const { return m_path; }
+    quint64 bytesRequested() const { return m_bytesRequested; }
+    quint64 bytesCompleted() const { return m_bytesCompleted; }
+    bool finished() const { return m_finished; }
+
+    TimePoint startTime() const { return m_startTime; }
+
+    quint64 startTimeNs() const { return m_startTime.ns(); }
+    quint64 endTimeNs() const { return m_endTime.ns(); }
+    quint64 inFlightTime() const { return m_endTime.ns() - m_startTime.ns(); }
+
+    /**
+     * @brief throughput - achieved bytes per second, zero until finished
+     */
+    qreal throughput() const;
+
+    void finish(quint64 bytesCompleted, TimePoint time);
+
+    void setEndTime(TimePoint time)
+    {
+        if (m_endTime == time)
+            return;
+
+        m_endTime = time;
+        emit endTimeChanged();
+    }
+
+signals:
+    void finishedChanged();
+    void endTimeChanged();
+
+private:
+    QString m_path;
+    quint64 m_bytesRequested;
+    quint64 m_bytesCompleted = 0;
+    bool m_finished = false;
+    TimePoint m_startTime;
+    TimePoint m_endTime;
+};
@@ -0,0 +1,126 @@
+#include "lane.h"
+
+#include <algorithm>
+
+LaneSample::LaneSample(TimePoint startTime, qreal value, Lane *parent)
+    : QObject(parent)
+    , m_startTime(startTime)
+    , m_endTime(startTime)
+    , m_value(value)
+{}
+
+Lane::Lane(const QString &name, const QString &unit, std::uint64_t binWidth, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+    , m_unit(unit)
+    , m_binWidth(binWidth)
+{}
+
+QQmlListProperty<LaneSample> Lane::samples() const
+{
+    QQmlListProperty<LaneSample> prop(const_cast<Lane *>(this), &const_cast<Lane *>(this)->m_samples);
+    prop.append = nullptr;
+    prop.clear = nullptr;
+    prop.replace = nullptr;
+    prop.removeLast = nullptr;
+    return prop;
+}
+
+void Lane::set(TimePoint time, qreal value)
+{
+    if (!m_samples.isEmpty()) {
+        if (m_samples.back()->startTime() == time) {
+            m_samples.back()->setValue(value);
+            updateMaxValue(value);
+            return;
+        }
+        m_samples.back()->setEndTime(time);
+    }
+    m_samples.push_back(new LaneSample(time, value, this));
+    updateMaxValue(value);
+    emit samplesChanged();
+}
+
+void Lane::add(TimePoint from, TimePoint to, qreal delta)
+{
+    Q_ASSERT(m_binWidth > 0 && from <= to);
+    const auto duration = to.ns() - from.ns();
+    const auto binOf = [this](std::uint64_t ns) { return ns - ns % m_binWidth; };
+    const auto firstBin = binOf(from.ns());
+    // a range ending on a bin boundary does not touch the bin starting there
+    const auto lastBin = binOf(duration > 0 ? to.ns() - 1 : to.ns());
+
+    // samples cover every bin from `firstBin` to `to`, bins without values read as zero
+    if (m_samples.isEmpty()) {
+        set(TimePoint::fromNs(firstBin), 0);
+    } else if (m_samples.front()->startTime().ns() > firstBin) {
+        auto *gap = new LaneSample(TimePoint::fromNs(firstBin), 0, this);
+        gap->setEndTime(m_samples.front()->startTime());
+        m_samples.prepend(gap);
+        emit samplesChanged();
+    }
+    extend(to);
+
+    // sample containing the first bin, every sample starts on a bin boundary
+    auto index = std::upper_bound(m_samples.cbegin(),
+                                  m_samples.cend(),
+                                  firstBin,
+                                  [](std::uint64_t ns, const LaneSample *sample) {
+                                      return ns < sample->startTime().ns();
+                                  })
+                 - m_samples.cbegin() - 1;
+
+    for (auto bin = firstBin; bin <= lastBin; bin += m_binWidth, ++index) {
+        index = splitAt(index, TimePoint::fromNs(bin));
+        if (m_samples[index]->endTime().ns() > bin + m_binWidth) {
+            splitAt(index, TimePoint::fromNs(bin + m_binWidth));
+        }
+
+        const auto overlap = std::min(to.ns(), bin + m_binWidth) - std::max(from.ns(), bin);
+        LaneSample *const sample = m_samples[index];
+        sample->setValue(sample->value()
+                         + (duration > 0 ? delta * qreal(overlap) / qreal(duration) : delta));
+        updateMaxValue(sample->value());
+    }
+}
+
+qsizetype Lane::splitAt(qsizetype index, TimePoint time)
+{
+    LaneSample *const sample = m_samples[index];
+    if (sample->startTime() == time)
+        return index;
+
+    // bins with values span exactly one bin, only gaps are ever split
+    Q_ASSERT(sample->startTime() < time && sample->value() == 0);
+    auto *rest = new LaneSample(time, 0, this);
+    rest->setEndTime(std::max(sample->endTime(), time));
+    sample->setEndTime(time);
+    m_samples.insert(index + 1, rest);
+    emit samplesChanged();
+    return index + 1;
+}
+
+void Lane::extend(TimePoint time)
+{
+    if (m_samples.isEmpty())
+        return;
+
+    if (m_binWidth > 0 && m_samples.back()->value() != 0) {
+        const auto binEnd = TimePoint::fromNs(m_samples.back()->startTime().ns() + m_binWidth);
+        if (binEnd <= time) {
+            set(binEnd, 0);
+        }
+    }
+    if (m_samples.back()->endTime() < time) {
+        m_samples.back()->setEndTime(time);
+    }
+}
+
+void Lane::updateMaxValue(qreal value)
+{
+    if (value <= m_maxValue)
+        return;
+
+    m_maxValue = value;
+    emit maxValueChanged();
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "logitem.h"
+
+#include <QObject>
+#include <QQmlListProperty>
+#include <QtQmlIntegration>
+
+class Lane;
+
+class LaneSample : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created by Lane only")
+
+    Q_PROPERTY(quint64 startTime READ startTimeNs CONSTANT)
+    Q_PROPERTY(quint64 endTime READ endTimeNs NOTIFY endTimeChanged)
+    Q_PROPERTY(qreal value READ value NOTIFY valueChanged)
+public:
+    explicit LaneSample(TimePoint startTime, qreal value, Lane *parent);
+
+    TimePoint startTime() const { return m_startTime; }
+    TimePoint endTime() const { return m_endTime; }
+
+    quint64 startTimeNs() const { return m_startTime.ns(); }
+    quint64 endTimeNs() const { return m_endTime.ns(); }
+
+    qreal value() const { return m_value; }
+
+    void setEndTime(TimePoint time)
+    {
+        if (m_endTime == time)
+            return;
+
+        m_endTime = time;
+        emit endTimeChanged();
+    }
+
+    void setValue(qreal value)
+    {
+        if (m_value == value)
+            return;
+
+        m_value = value;
+        emit valueChanged();
+    }
+
+signals:
+    void endTimeChanged();
+    void valueChanged();
+
+private:
+    TimePoint m_startTime;
+    TimePoint m_endTime;
+    qreal m_value;
+};
+
+/**
+ * @brief The Lane class - step function of some aggregate value over time.
+ * Each sample holds the value from its start time until the start of the next one.
+ * A binned lane (`binWidth` > 0) instead sums values `add`ed into fixed width time bins,
+ * so every update touches only the bins of its own time range.
+ */
+class Lane : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created by Monitor only")
+
+    Q_PROPERTY(QString name READ name CONSTANT)
+    Q_PROPERTY(QString unit READ unit CONSTANT)
+    Q_PROPERTY(qreal maxValue READ maxValue NOTIFY maxValueChanged)
+    Q_PROPERTY(QQmlListProperty<LaneSample> samples READ samples NOTIFY samplesChanged)
+public:
+    Lane(const QString &name,
+         const QString &unit,
+         std::uint64_t binWidth = 0,
+         QObject *parent = nullptr);
+
+    QString name() const { return m_name; }
+    QString unit() const { return m_unit; }
+    qreal maxValue() const { return m_maxValue; }
+    QQmlListProperty<LaneSample> samples() const;
+
+    /**
+     * @brief set - close the current sample at `time` and start a new one with `value`
+     */
+    void set(TimePoint time, qreal value);
+
+    /**
+     * @brief add - spread `delta` over the bins of [from, to] in proportion to their overlap
+     * with it, binned lanes only. All of it goes into one bin if `from` == `to`.
+     */
+    void add(TimePoint from, TimePoint to, qreal delta);
+
+    /**
+     * @brief extend - stretch the current sample up to `time`, a bin only up to its width
+     */
+    void extend(TimePoint time);
+
+    qsizetype currentIndex() const { return m_samples.size() - 1; }
+    qreal value() const { return m_samples.isEmpty() ? 0 : m_samples.back()->value(); }
+
+signals:
+    void maxValueChanged();
+    void samplesChanged();
+
+private:
+    void updateMaxValue(qreal value);
+
+    /**
+     * @brief splitAt - make `time` the start of a sample, splitting the (zero) sample containing it
+     * @param index - index of the sample containing `time`
+     * @return index of the sample starting at `time`
+     */
+    qsizetype splitAt(qsizetype index, TimePoint time);
+
+private:
+    QString m_name;
+    QString m_unit;
+    std::uint64_t m_binWidth;
+    qreal m_maxValue = 0;
+    QList<LaneSample *> m_samples;
+};
@@ -0,0 +1,104 @@
+#include "locationstats.h"
+#include "logitem.h"
+
+LocationStats::LocationStats(const char *functionName, QObject *parent)
+    : QObject(parent)
+    , m_functionName(functionName)
+{}
+
+LocationStats::LocationStats(const LocationStats &other, QObject *parent)
+    : QObject(parent)
+    , m_functionName(other.m_functionName)
+    , m_taskCount(other.m_taskCount)
+    , m_suspendCount(other.m_suspendCount)
+    , m_frameSize(other.m_frameSize)
+    , m_liveFrames(other.m_liveFrames)
+    , m_liveBytes(other.m_liveBytes)
+    , m_peakBytes(other.m_peakBytes)
+    , m_suspendedThreshold(other.m_suspendedThreshold)
+    , m_resumedThreshold(other.m_resumedThreshold)
+    , m_cpuTime(other.m_cpuTime)
+    , m_offCpuTime(other.m_offCpuTime)
+    , m_hasCounters(other.m_hasCounters)
+    , m_counters(other.m_counters)
+    , m_workTime(other.m_workTime)
+    , m_wallTime(other.m_wallTime)
+    , m_readyLatency(other.m_readyLatency)
+{}
+
+void LocationStats::setSuspendedThreshold(quint64 threshold)
+{
+    if (m_suspendedThreshold == threshold)
+        return;
+    m_suspendedThreshold = threshold;
+    emit suspendedThresholdChanged();
+}
+
+void LocationStats::setResumedThreshold(quint64 threshold)
+{
+    if (m_resumedThreshold == threshold)
+        return;
+    m_resumedThreshold = threshold;
+    emit resumedThresholdChanged();
+}
+
+void LocationStats::addCpuTime(quint64 cpuTime, quint64 offCpuTime)
+{
+    m_cpuTime += cpuTime;
+    m_offCpuTime += offCpuTime;
+    emit cpuTimeChanged();
+}
+
+void LocationStats::countSuspend()
+{
+    ++m_suspendCount;
+    emit suspendCountChanged();
+}
+
+QVariantMap LocationStats::counters() const
+{
+    return m_hasCounters ? LogItem::countersMap(m_counters) : QVariantMap();
+}
+
+void LocationStats::addCounters(const perfcounters::Values &counters)
+{
+    m_hasCounters = true;
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        m_counters[i] += counters[i];
+    }
+    emit countersChanged();
+}
+
+void LocationStats::taskStarted(quint64 frameSize)
+{
+    ++m_taskCount;
+    emit taskCountChanged();
+
+    if (frameSize == 0)
+        return;
+
+    if (frameSize > m_frameSize) {
+        m_frameSize = frameSize;
+        emit frameSizeChanged();
+    }
+
+    ++m_liveFrames;
+    m_liveBytes += frameSize;
+    emit liveBytesChanged();
+
+    if (m_liveBytes > m_peakBytes) {
+        m_peakBytes = m_liveBytes;
+        emit peakBytesChanged();
+    }
+}
+
+void LocationStats::taskFinished(quint64 frameSize)
+{
+    if (frameSize == 0)
+        return;
+
+    Q_ASSERT(m_liveFrames > 0 && m_liveBytes >= frameSize);
+    --m_liveFrames;
+    m_liveBytes -= frameSize;
+    emit liveBytesChanged();
+}
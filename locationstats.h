@@ -0,0 +1,147 @@
+#pragma once
+
+#include "histogram.h"
+#include "perfcounters.h"
+
+#include <QObject>
+#include <QVariantMap>
+#include <QtQmlIntegration>
+#include <string>
+
+/**
+ * @brief The LocationStats class - aggregates of all tasks started from the same source location
+ */
+class LocationStats : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created by Monitor only")
+
+    Q_PROPERTY(QString location READ location CONSTANT)
+    Q_PROPERTY(quint64 taskCount READ taskCount NOTIFY taskCountChanged)
+    Q_PROPERTY(quint64 suspendCount READ suspendCount NOTIFY suspendCountChanged)
+    Q_PROPERTY(quint64 frameSize READ frameSize NOTIFY frameSizeChanged)
+    Q_PROPERTY(quint64 liveFrames READ liveFrames NOTIFY liveBytesChanged)
+    Q_PROPERTY(quint64 liveBytes READ liveBytes NOTIFY liveBytesChanged)
+    Q_PROPERTY(quint64 peakBytes READ peakBytes NOTIFY peakBytesChanged)
+    Q_PROPERTY(quint64 cpuTime READ cpuTime NOTIFY cpuTimeChanged)
+    Q_PROPERTY(quint64 offCpuTime READ offCpuTime NOTIFY cpuTimeChanged)
+    Q_PROPERTY(QVariantMap counters READ counters NOTIFY countersChanged)
+    Q_PROPERTY(quint64 suspendedThreshold READ suspendedThreshold WRITE setSuspendedThreshold NOTIFY
+                   suspendedThresholdChanged)
+    Q_PROPERTY(quint64 resumedThreshold READ resumedThreshold WRITE setResumedThreshold NOTIFY
+                   resumedThresholdChanged)
+public:
+    LocationStats(const char *functionName, QObject *parent = nullptr);
+
+    /**
+     * @brief LocationStats - copy of `other` owned by `parent`, for snapshots
+     */
+    LocationStats(const LocationStats &other, QObject *parent);
+
+    /**
+     * @brief key - stable storage for the lookup key of this location
+     */
+    const std::string &key() const { return m_functionName; }
+
+    /**
+     * @brief snapshotEpoch - epoch of the newest snapshot which has seen the current state, see `Monitor::preserve`
+     */
+    quint64 snapshotEpoch() const { return m_snapshotEpoch; }
+    void setSnapshotEpoch(quint64 epoch) { m_snapshotEpoch = epoch; }
+
+    QString location() const { return QString::fromStdString(m_functionName); }
+    quint64 taskCount() const { return m_taskCount; }
+
+    /**
+     * @brief suspendCount - suspensions of all tasks of this location
+     */
+    quint64 suspendCount() const { return m_suspendCount; }
+    void countSuspend();
+
+    /**
+     * @brief frameSize - largest coroutine frame allocated for this location, zero if not accounted
+     */
+    quint64 frameSize() const { return m_frameSize; }
+    quint64 liveFrames() const { return m_liveFrames; }
+    quint64 liveBytes() const { return m_liveBytes; }
+    quint64 peakBytes() const { return m_peakBytes; }
+
+    /**
+     * @brief suspendedThreshold - stall threshold of the suspended state in ns, zero if disabled
+     */
+    quint64 suspendedThreshold() const { return m_suspendedThreshold; }
+    void setSuspendedThreshold(quint64 threshold);
+
+    /**
+     * @brief resumedThreshold - stall threshold of the resumed state in ns, zero if disabled
+     */
+    quint64 resumedThreshold() const { return m_resumedThreshold; }
+    void setResumedThreshold(quint64 threshold);
+
+    void taskStarted(quint64 frameSize);
+    void taskFinished(quint64 frameSize);
+
+    /**
+     * @brief workTime - work time of finished tasks of this location
+     */
+    const Histogram &workTime() const { return m_workTime; }
+
+    /**
+     * @brief readyLatency - time from suspend (or start) to the following resume
+     */
+    const Histogram &readyLatency() const { return m_readyLatency; }
+
+    void observeWorkTime(quint64 ns) { m_workTime.observe(ns); }
+
+    /**
+     * @brief wallTime - time from start to finish of finished tasks of this location
+     */
+    const Histogram &wallTime() const { return m_wallTime; }
+    void observeWallTime(quint64 ns) { m_wallTime.observe(ns); }
+
+    /**
+     * @brief cpuTime - CPU time of resumed slices with a known CPU time, see `LogItem::hasCpuTime`
+     */
+    quint64 cpuTime() const { return m_cpuTime; }
+    quint64 offCpuTime() const { return m_offCpuTime; }
+    void addCpuTime(quint64 cpuTime, quint64 offCpuTime);
+    void observeReadyLatency(quint64 ns) { m_readyLatency.observe(ns); }
+
+    /**
+     * @brief counters - perf counter totals of resumed slices with counters, see `LogItem::hasCounters`
+     */
+    QVariantMap counters() const;
+    const perfcounters::Values &counterValues() const { return m_counters; }
+    void addCounters(const perfcounters::Values &counters);
+
+signals:
+    void taskCountChanged();
+    void suspendCountChanged();
+    void frameSizeChanged();
+    void liveBytesChanged();
+    void peakBytesChanged();
+    void suspendedThresholdChanged();
+    void resumedThresholdChanged();
+    void cpuTimeChanged();
+    void countersChanged();
+
+private:
+    std::string m_functionName;
+    quint64 m_taskCount = 0;
+    quint64 m_suspendCount = 0;
+    quint64 m_frameSize = 0;
+    quint64 m_liveFrames = 0;
+    quint64 m_liveBytes = 0;
+    quint64 m_peakBytes = 0;
+    quint64 m_suspendedThreshold = 0;
+    quint64 m_resumedThreshold = 0;
+    quint64 m_cpuTime = 0;
+    quint64 m_offCpuTime = 0;
+    bool m_hasCounters = false;
+    perfcounters::Values m_counters{};
+    Histogram m_workTime;
+    Histogram m_wallTime;
+    Histogram m_readyLatency;
+    quint64 m_snapshotEpoch = 0;
+};
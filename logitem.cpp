@@ -21,3 +21,26 @@ LogItem::LogItem(State state, TimePoint startTime, Task *parent)
     , m_startTime(startTime)
     , m_endTime(startTime)
 {}
+
+LogItem::LogItem(const LogItem &other, Task *parent)
+    : QObject(parent)
+    , m_state(other.m_state)
+    , m_startTime(other.m_startTime)
+    , m_endTime(other.m_endTime)
+    , m_stalled(other.m_stalled)
+    , m_hasCpuTime(other.m_hasCpuTime)
+    , m_cpuTime(other.m_cpuTime)
+    , m_offCpuTime(other.m_offCpuTime)
+    , m_hasCounters(other.m_hasCounters)
+    , m_counters(other.m_counters)
+{}
+
+QVariantMap LogItem::countersMap(const perfcounters::Values &values)
+{
+    QVariantMap result;
+    const auto names = perfcounters::names();
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        result.insert(QString::fromLatin1(names[i]), quint64(values[i]));
+    }
+    return result;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "perfcounters.h"
+
 #include <QObject>
+#include <QVariantMap>
 #include <QtQmlIntegration>
 
 class Monitor;
@@ -21,11 +24,22 @@ public:
             .count();
     }
 
+    /**
+     * @brief fromNs - time point which is already relative to the monitor start
+     */
+    static TimePoint fromNs(std::uint64_t ns)
+    {
+        TimePoint result;
+        result.m_ns = ns;
+        return result;
+    }
+
     std::uint64_t ns() const { return m_ns; };
 
     std::strong_ordering operator<=>(const TimePoint &) const = default;
 
 private:
+    TimePoint() = default;
     TimePoint(Monitor *monitor, std::uint64_t timestamp);
 
 private:
@@ -45,9 +59,20 @@ private:
     Q_PROPERTY(State state MEMBER m_state CONSTANT)
     Q_PROPERTY(quint64 startTime READ startTimeNs NOTIFY startTimeChanged)
     Q_PROPERTY(quint64 endTime READ endTimeNs NOTIFY endTimeChanged)
+    Q_PROPERTY(bool stalled READ stalled NOTIFY stalledChanged)
+    Q_PROPERTY(bool hasCpuTime READ hasCpuTime NOTIFY cpuTimeChanged)
+    Q_PROPERTY(quint64 cpuTime READ cpuTime NOTIFY cpuTimeChanged)
+    Q_PROPERTY(quint64 offCpuTime READ offCpuTime NOTIFY cpuTimeChanged)
+    Q_PROPERTY(bool hasCounters READ hasCounters NOTIFY countersChanged)
+    Q_PROPERTY(QVariantMap counters READ counters NOTIFY countersChanged)
 public:
     explicit LogItem(State state, TimePoint startTime, Task *parent);
 
+    /**
+     * @brief LogItem - copy of `other` owned by `parent`, for frozen tasks
+     */
+    LogItem(const LogItem &other, Task *parent);
+
     State state() const { return m_state; }
 
     TimePoint startTime() const { return m_startTime; }
@@ -65,12 +90,83 @@ public:
         emit endTimeChanged();
     }
 
+    /**
+     * @brief stalled - the task stayed in this state longer than its stall threshold
+     */
+    bool stalled() const { return m_stalled; }
+
+    void setStalled(bool stalled)
+    {
+        if (m_stalled == stalled)
+            return;
+
+        m_stalled = stalled;
+        emit stalledChanged();
+    }
+
+    /**
+     * @brief hasCpuTime - CPU time is known, only for `Resumed` items suspended on the thread they were resumed on
+     */
+    bool hasCpuTime() const { return m_hasCpuTime; }
+
+    /**
+     * @brief cpuTime - time the thread was actually running the slice
+     */
+    quint64 cpuTime() const { return m_cpuTime; }
+
+    /**
+     * @brief offCpuTime - wall time of the slice minus `cpuTime`: preemption, blocking syscalls, ...
+     */
+    quint64 offCpuTime() const { return m_offCpuTime; }
+
+    void setCpuTime(quint64 cpuTime, quint64 offCpuTime)
+    {
+        m_hasCpuTime = true;
+        m_cpuTime = cpuTime;
+        m_offCpuTime = offCpuTime;
+        emit cpuTimeChanged();
+    }
+
+    /**
+     * @brief hasCounters - perf counters are known, only for `Resumed` items suspended on the
+     * thread they were resumed on while `--perf-counters` is enabled
+     */
+    bool hasCounters() const { return m_hasCounters; }
+
+    /**
+     * @brief counterValues - counted during the slice, in `perfcounters::names` order
+     */
+    const perfcounters::Values &counterValues() const { return m_counters; }
+
+    /**
+     * @brief counters - counter name to value, empty if not `hasCounters`
+     */
+    QVariantMap counters() const { return m_hasCounters ? countersMap(m_counters) : QVariantMap(); }
+
+    void setCounters(const perfcounters::Values &counters)
+    {
+        m_hasCounters = true;
+        m_counters = counters;
+        emit countersChanged();
+    }
+
+    static QVariantMap countersMap(const perfcounters::Values &values);
+
 signals:
     void startTimeChanged();
     void endTimeChanged();
+    void stalledChanged();
+    void cpuTimeChanged();
+    void countersChanged();
 
 private:
     State m_state;
     TimePoint m_startTime;
     TimePoint m_endTime;
+    bool m_stalled = false;
+    bool m_hasCpuTime = false;
+    quint64 m_cpuTime = 0;
+    quint64 m_offCpuTime = 0;
+    bool m_hasCounters = false;
+    perfcounters::Values m_counters{};
 };
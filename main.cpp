@@ -1,69 +1,291 @@
+#include "metricsserver.h"
 #include "monitor.h"
+#include "perfcounters.h"
+#include "stalldetector.h"
+#include "summary.h"
+#include "summarydiff.h"
+#include "workload.h"
 
+#include <QCommandLineParser>
+#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
-#include <coschedula/fs.h>
+#include <algorithm>
 #include <coschedula/task.h>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <optional>
 
-int main(int argc, char *argv[])
+namespace {
+
+/**
+ * @brief The EmptySubscriber class - baseline for `--subscriber empty`
+ */
+class EmptySubscriber : public coschedula::scheduler::subscriber
+{
+public:
+    EmptySubscriber()
+    {
+        coschedula::scheduler::instance<coschedula::scheduler>.install_subscriber(*this);
+    }
+
+    void task_started(const coschedula::scheduler::task_info &) override {}
+    void task_finished(const coschedula::scheduler::task_info &) override {}
+    void task_suspended(const coschedula::scheduler::task_info &) override {}
+    void task_resumed(const coschedula::scheduler::task_info &) override {}
+};
+
+/**
+ * @brief runHeadless - run the workload to completion and print how long it took
+ * @param seenTasks - returns the number of tasks the subscriber saw, if it knows
+ * @param processEvents - run the event loop between steps, e.g. to serve metrics scrapes
+ */
+template<typename F>
+int runHeadless(Workload &workload, F &&seenTasks, bool processEvents = false)
+{
+    if (!workload.prepare()) {
+        std::cerr << "failed to write temp file" << std::endl;
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    workload.start();
+    while (coschedula::scheduler::instance<coschedula::scheduler>.proceed()) {
+        if (processEvents) {
+            QCoreApplication::processEvents();
+        }
+    }
+    const auto elapsed = timer.nsecsElapsed();
+
+    const auto expected = workload.options().taskCount();
+    const std::optional<std::size_t> seen = seenTasks();
+    std::cout << "tasks: " << (seen ? QString::number(*seen) : QStringLiteral("-")).toStdString()
+              << " (expected " << expected << ")" << std::endl
+              << "elapsed: " << elapsed / 1000 / 1000 << " ms" << std::endl
+              << "per task: " << (expected ? elapsed / expected : 0) << " ns" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief compareSummaries - `--compare <baseline> <candidate>`, prints the diff when headless, shows it otherwise
+ * @return 2 when headless and a regression is above `--threshold`
+ */
+int compareSummaries(const QCommandLineParser &parser, QCoreApplication &app, bool headless)
 {
-    QGuiApplication app(argc, argv);
+    const auto files = parser.positionalArguments();
+    if (files.size() != 2) {
+        std::cerr << "--compare needs a baseline and a candidate summary" << std::endl;
+        return 1;
+    }
+
+    bool thresholdOk = false;
+    const double threshold = parser.value(QStringLiteral("threshold")).toDouble(&thresholdOk);
+    if (!thresholdOk || threshold < 0) {
+        std::cerr << "invalid --threshold" << std::endl;
+        return 1;
+    }
+
+    QString error;
+    const auto baseline = Summary::load(files[0], &error);
+    const auto candidate = baseline ? Summary::load(files[1], &error) : std::nullopt;
+    if (!baseline || !candidate) {
+        std::cerr << qPrintable(error) << std::endl;
+        return 1;
+    }
+
+    SummaryDiff diff(*baseline, *candidate, threshold);
+    if (headless) {
+        std::cout << qPrintable(diff.report()) << std::flush;
+        return diff.regressionCount() > 0 ? 2 : 0;
+    }
 
     QQmlApplicationEngine engine;
+    engine.setInitialProperties({{"diff", QVariant::fromValue(&diff)}});
+    QObject::connect(
+        &engine,
+        &QQmlApplicationEngine::objectCreationFailed,
+        &app,
+        []() { QCoreApplication::exit(-1); },
+        Qt::QueuedConnection);
+    engine.loadFromModule("coschedula_monitor", "SummaryDiffView");
+    return app.exec();
+}
 
-    MonitorImpl<coschedula::scheduler> mon;
+/**
+ * @brief saveSummary - write the `--save-summary` file, if one was requested
+ */
+bool saveSummary(const Monitor &monitor, const QString &path)
+{
+    if (path.isEmpty())
+        return true;
+
+    QString error;
+    if (!Summary::of(monitor).save(path, &error)) {
+        std::cerr << qPrintable(error) << std::endl;
+        return false;
+    }
+    std::cout << "summary: " << qPrintable(path) << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // The application object has to exist before the command line can be parsed,
+    // so `--headless` is looked up by hand to avoid requiring a display.
+    const bool headless = std::any_of(argv + 1, argv + argc, [](const char *arg) {
+        return std::strcmp(arg, "--headless") == 0;
+    });
+    const std::unique_ptr<QCoreApplication> app = headless
+                                                      ? std::make_unique<QCoreApplication>(argc, argv)
+                                                      : std::make_unique<QGuiApplication>(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("coschedula monitor"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("headless"),
+                      QStringLiteral("Run the workload without UI and print ingestion statistics.")});
+    parser.addOption({QStringLiteral("subscriber"),
+                      QStringLiteral("With --headless: model (the Qt model), counters (counter-only policy), "
+                                     "empty (subscriber doing nothing) or none."),
+                      QStringLiteral("kind"),
+                      QStringLiteral("model")});
+    parser.addOption({QStringLiteral("metrics-port"),
+                      QStringLiteral("Serve OpenMetrics on http://localhost:<port>/metrics, 0 disables."),
+                      QStringLiteral("port"),
+                      QStringLiteral("0")});
+    parser.addOption({QStringLiteral("perf-counters"),
+                      QStringLiteral("Count cycles, instructions, cache and branch misses per resumed slice "
+                                     "(Linux, falls back to software events).")});
+    parser.addOption({QStringLiteral("save-summary"),
+                      QStringLiteral("Write a per-location summary to <file> once the workload finished."),
+                      QStringLiteral("file")});
+    parser.addOption({QStringLiteral("compare"),
+                      QStringLiteral("Compare two summaries instead of running the workload. With --headless "
+                                     "print the ranked diff and exit with 2 on a regression.")});
+    parser.addOption({QStringLiteral("threshold"),
+                      QStringLiteral("With --compare: relative slowdown of a mean counted as regression when it is significant."),
+                      QStringLiteral("ratio"),
+                      QStringLiteral("0.1")});
+    parser.addPositionalArgument(QStringLiteral("summaries"),
+                                 QStringLiteral("With --compare: baseline and candidate summary."),
+                                 QStringLiteral("[baseline candidate]"));
+    Workload::addOptions(parser);
+    StallDetector::addOptions(parser);
+    parser.process(*app);
+
+    if (parser.isSet(QStringLiteral("compare"))) {
+        return compareSummaries(parser, *app, headless);
+    }
+
+    QString error;
+    const auto options = Workload::parseOptions(parser, &error);
+    const auto stallOptions = options ? StallDetector::parseOptions(parser, &error) : std::nullopt;
+    if (!options || !stallOptions) {
+        std::cerr << qPrintable(error) << std::endl;
+        return 1;
+    }
+
+    const auto subscriber = parser.value(QStringLiteral("subscriber"));
+    const auto summaryPath = parser.value(QStringLiteral("save-summary"));
+    if (!summaryPath.isEmpty() && subscriber != QStringLiteral("model")) {
+        std::cerr << "--save-summary needs --subscriber model" << std::endl;
+        return 1;
+    }
 
-    const auto &&subtask = []() -> coschedula::task<int, coschedula::scheduler> {
-        for (std::size_t i = 0; i < 4; ++i) {
-            co_await coschedula::suspend{};
+    if (headless && subscriber == QStringLiteral("counters")) {
+        MonitorImpl<coschedula::scheduler, CountersPolicy> mon;
+        Workload workload(nullptr, *options);
+        return runHeadless(workload, [&mon] {
+            return std::optional<std::size_t>(mon.count(EventKind::Started));
+        });
+    } else if (headless && subscriber == QStringLiteral("empty")) {
+        EmptySubscriber mon;
+        Workload workload(nullptr, *options);
+        return runHeadless(workload, [] { return std::optional<std::size_t>(); });
+    } else if (headless && subscriber == QStringLiteral("none")) {
+        Workload workload(nullptr, *options);
+        return runHeadless(workload, [] { return std::optional<std::size_t>(); });
+    } else if (subscriber != QStringLiteral("model")) {
+        std::cerr << "invalid --subscriber, only model is available with UI" << std::endl;
+        return 1;
+    }
+
+    bool portOk = false;
+    const auto metricsPort = parser.value(QStringLiteral("metrics-port")).toUShort(&portOk);
+    if (!portOk) {
+        std::cerr << "invalid --metrics-port" << std::endl;
+        return 1;
+    }
+
+    if (parser.isSet(QStringLiteral("perf-counters"))) {
+        switch (perfcounters::enable()) {
+        case perfcounters::Mode::Hardware:
+            std::cout << "perf counters: hardware" << std::endl;
+            break;
+        case perfcounters::Mode::Software:
+            std::cout << "perf counters: hardware not available, using software events" << std::endl;
+            break;
+        case perfcounters::Mode::Disabled:
+            std::cerr << "perf counters not available, check perf_event_paranoid" << std::endl;
+            break;
         }
-        co_return 1;
-    };
-
-    std::ifstream stream("/home/borys/datasets/large_text_files/mediumfile0.txt");
-    assert(stream.is_open());
-    assert(stream.good());
-    std::cout << "mediumfile0.txt: "
-              << std::string((std::istreambuf_iterator(stream)), std::istreambuf_iterator<char>())
-                     .size()
-              << std::endl;
-
-    const auto &&task = [&subtask]() -> coschedula::task<int, coschedula::scheduler> {
-        co_await coschedula::suspend{};
-        const auto st = subtask();
-
-        const auto fstask = coschedula::fs::read<std::string::value_type, coschedula::execution::par>(
-            "/home/borys/datasets/large_text_files/mediumfile0.txt");
-
-        for (std::size_t i = 0; i < 4; ++i) {
-            co_await coschedula::suspend{};
+    }
+
+    MonitorImpl<coschedula::scheduler> mon;
+    mon.setStallOptions(*stallOptions);
+
+    MetricsServer metrics(&mon);
+    if (metricsPort != 0) {
+        if (!metrics.listen(metricsPort)) {
+            std::cerr << "failed to listen on port " << metricsPort << std::endl;
+            return 1;
         }
-        co_await st;
-        const auto str = co_await fstask;
-        std::cout << "str: " << str.size() << std::endl;
-        co_return 1;
-    };
+        std::cout << "metrics: http://localhost:" << metrics.port() << "/metrics" << std::endl;
+    }
+    Workload workload(&mon, *options);
+
+    if (headless) {
+        const int result = runHeadless(
+            workload,
+            [&mon] { return std::optional<std::size_t>(mon.taskCount()); },
+            metricsPort != 0);
+        if (result == 0 && !saveSummary(mon, summaryPath))
+            return 1;
+        return result;
+    }
 
+    QQmlApplicationEngine engine;
     engine.setInitialProperties({{"monitor", QVariant::fromValue(&mon)}});
 
     QObject::connect(
         &engine,
         &QQmlApplicationEngine::objectCreationFailed,
-        &app,
+        app.get(),
         []() { QCoreApplication::exit(-1); },
         Qt::QueuedConnection);
     engine.loadFromModule("coschedula_monitor", "Main");
 
     QTimer t;
-    QObject::connect(&t, &QTimer::timeout, [&t]() {
+    QObject::connect(&t, &QTimer::timeout, [&t, &mon, &summaryPath]() {
         if (!coschedula::scheduler::instance<coschedula::scheduler>.proceed()) {
             t.stop();
+            saveSummary(mon, summaryPath);
         }
     });
     t.start(0);
 
-    QMetaObject::invokeMethod(&app, [&task]() { task(); });
+    QMetaObject::invokeMethod(app.get(), [&workload]() {
+        if (!workload.prepare()) {
+            std::cerr << "failed to write temp file" << std::endl;
+            QCoreApplication::exit(1);
+            return;
+        }
+        workload.start();
+    });
 
-    return app.exec();
+    return app->exec();
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief The MeanDiff struct - change of a mean between two runs and whether it stands out of the
+ * noise. It is significant when both runs have at least `MinSamples` samples and the means differ
+ * by at least `MinZScore` standard errors (Welch's z). Does not depend on Qt so it can be tested
+ * on its own, `SummaryDiffEntry` wraps it for the model.
+ */
+struct MeanDiff
+{
+    static constexpr std::uint64_t MinSamples = 5;
+    static constexpr double MinZScore = 3;
+
+    struct Sample
+    {
+        std::uint64_t count = 0;
+        double mean = 0;
+        double stddev = 0;
+    };
+
+    /**
+     * @brief change - relative change of the mean, 0.1 means 10% slower
+     */
+    double change = 0;
+
+    /**
+     * @brief zScore - difference of the means in standard errors, infinite when both runs have no
+     * spread and the means differ, 0 without enough samples
+     */
+    double zScore = 0;
+    bool significant = false;
+
+    static MeanDiff compare(const Sample &baseline, const Sample &candidate)
+    {
+        MeanDiff result;
+        if (baseline.mean > 0) {
+            result.change = candidate.mean / baseline.mean - 1;
+        }
+        if (baseline.count < MinSamples || candidate.count < MinSamples) {
+            return result;
+        }
+
+        const double difference = candidate.mean - baseline.mean;
+        const double standardError = std::sqrt(
+            baseline.stddev * baseline.stddev / double(baseline.count)
+            + candidate.stddev * candidate.stddev / double(candidate.count));
+        // both runs without any spread, e.g. fixed busy work: every difference is real
+        if (standardError > 0) {
+            result.zScore = difference / standardError;
+        } else if (difference != 0) {
+            constexpr double infinity = std::numeric_limits<double>::infinity();
+            result.zScore = difference > 0 ? infinity : -infinity;
+        }
+        result.significant = std::abs(result.zScore) >= MinZScore;
+        return result;
+    }
+
+    /**
+     * @brief regression - significant and slower by more than `threshold`
+     */
+    bool regression(double threshold) const { return significant && change > threshold; }
+
+    /**
+     * @brief ranksBefore - significant changes first, each group from the largest slowdown to the
+     * largest improvement, so noise never hides a real regression
+     */
+    static bool ranksBefore(const MeanDiff &a, const MeanDiff &b)
+    {
+        if (a.significant != b.significant) {
+            return a.significant;
+        }
+        return a.change > b.change;
+    }
+};
@@ -0,0 +1,168 @@
+#include "metricsserver.h"
+#include "monitor.h"
+
+#include <QTcpSocket>
+
+namespace {
+
+constexpr qsizetype MaxRequestSize = 8 * 1024;
+
+struct StateName
+{
+    LogItem::State state;
+    const char *name;
+};
+
+constexpr StateName StateNames[] = {
+    {LogItem::State::Started, "started"},
+    {LogItem::State::Suspended, "suspended"},
+    {LogItem::State::Resumed, "resumed"},
+    {LogItem::State::Finished, "finished"},
+};
+
+QByteArray escapeLabel(const QString &value)
+{
+    QByteArray result;
+    for (const char c : value.toUtf8()) {
+        switch (c) {
+        case '\\':
+            result += "\\\\";
+            break;
+        case '"':
+            result += "\\\"";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        default:
+            result += c;
+        }
+    }
+    return result;
+}
+
+QByteArray seconds(double ns)
+{
+    return QByteArray::number(ns / 1e9, 'g', 10);
+}
+
+void renderHistogram(QByteArray &out,
+                     const QByteArray &name,
+                     const QByteArray &labels,
+                     const Histogram &histogram)
+{
+    constexpr auto bounds = Histogram::bounds();
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+        cumulative += histogram.bucket(i);
+        out += name + "_bucket{" + labels + ",le=\"" + seconds(bounds[i]) + "\"} "
+               + QByteArray::number(cumulative) + '\n';
+    }
+    out += name + "_bucket{" + labels + ",le=\"+Inf\"} " + QByteArray::number(histogram.count())
+           + '\n';
+    out += name + "_sum{" + labels + "} " + seconds(histogram.sum()) + '\n';
+    out += name + "_count{" + labels + "} " + QByteArray::number(histogram.count()) + '\n';
+}
+
+void respond(QTcpSocket *socket, const QByteArray &status, const QByteArray &type, const QByteArray &body)
+{
+    socket->write("HTTP/1.1 " + status + "\r\nContent-Type: " + type
+                  + "\r\nContent-Length: " + QByteArray::number(body.size())
+                  + "\r\nConnection: close\r\n\r\n" + body);
+    socket->disconnectFromHost();
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(const Monitor *monitor, QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsServer::handleConnection);
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    return m_server.listen(QHostAddress::LocalHost, port);
+}
+
+QByteArray MetricsServer::render(const Monitor &monitor)
+{
+    QByteArray out;
+
+    out += "# TYPE coschedula_tasks gauge\n"
+           "# HELP coschedula_tasks Live tasks by current state.\n";
+    for (const auto &[state, name] : StateNames) {
+        if (state == LogItem::State::Finished)
+            continue;
+        out += QByteArray("coschedula_tasks{state=\"") + name + "\"} "
+               + QByteArray::number(monitor.liveTaskCount(state)) + '\n';
+    }
+
+    out += "# TYPE coschedula_tasks_finished counter\n"
+           "# HELP coschedula_tasks_finished Tasks finished so far.\n"
+           "coschedula_tasks_finished_total "
+           + QByteArray::number(monitor.liveTaskCount(LogItem::State::Finished)) + '\n';
+
+    out += "# TYPE coschedula_events counter\n"
+           "# HELP coschedula_events Scheduler events ingested by kind.\n";
+    for (const auto &[state, name] : StateNames) {
+        out += QByteArray("coschedula_events_total{kind=\"") + name + "\"} "
+               + QByteArray::number(monitor.eventCount(state)) + '\n';
+    }
+
+    out += "# TYPE coschedula_task_work_seconds histogram\n"
+           "# HELP coschedula_task_work_seconds Time spent resumed by finished tasks.\n"
+           "# UNIT coschedula_task_work_seconds seconds\n";
+    for (const LocationStats *location : monitor.locationList()) {
+        renderHistogram(out,
+                        "coschedula_task_work_seconds",
+                        "location=\"" + escapeLabel(location->location()) + '"',
+                        location->workTime());
+    }
+
+    out += "# TYPE coschedula_task_ready_latency_seconds histogram\n"
+           "# HELP coschedula_task_ready_latency_seconds Time from suspend to the next resume.\n"
+           "# UNIT coschedula_task_ready_latency_seconds seconds\n";
+    for (const LocationStats *location : monitor.locationList()) {
+        renderHistogram(out,
+                        "coschedula_task_ready_latency_seconds",
+                        "location=\"" + escapeLabel(location->location()) + '"',
+                        location->readyLatency());
+    }
+
+    out += "# EOF\n";
+    return out;
+}
+
+void MetricsServer::handleConnection()
+{
+    while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+            if (socket->property("handled").toBool())
+                return;
+
+            const auto request = socket->peek(MaxRequestSize);
+            if (!request.contains("\r\n\r\n")) {
+                if (request.size() >= MaxRequestSize) {
+                    respond(socket, "431 Request Header Fields Too Large", "text/plain", {});
+                }
+                return;
+            }
+            socket->setProperty("handled", true);
+
+            const auto requestLine = request.left(request.indexOf("\r\n")).split(' ');
+            if (requestLine.size() != 3 || requestLine[0] != "GET") {
+                respond(socket, "405 Method Not Allowed", "text/plain", "only GET is supported\n");
+            } else if (requestLine[1] != "/metrics") {
+                respond(socket, "404 Not Found", "text/plain", "try /metrics\n");
+            } else {
+                respond(socket,
+                        "200 OK",
+                        "application/openmetrics-text; version=1.0.0; charset=utf-8",
+                        render(*m_monitor));
+            }
+        });
+    }
+}
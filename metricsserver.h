@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QTcpServer>
+
+class Monitor;
+
+/**
+ * @brief The MetricsServer class - serves `GET /metrics` in OpenMetrics text format on localhost.
+ * Everything is read from counters and histograms the Monitor keeps up to date while ingesting,
+ * so a scrape costs O(locations) and never walks the task list.
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    MetricsServer(const Monitor *monitor, QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+    quint16 port() const { return m_server.serverPort(); }
+
+    static QByteArray render(const Monitor &monitor);
+
+private:
+    void handleConnection();
+
+private:
+    const Monitor *m_monitor;
+    QTcpServer m_server;
+};
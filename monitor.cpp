@@ -1,15 +1,67 @@
 #include "monitor.h"
 #include "matrix.h"
+#include "snapshot.h"
 
+#include <QDebug>
 #include <QPainter>
+#include <QQmlEngine>
+#include <QStringList>
+
+namespace {
+
+// stalls are logged at most once per this interval (ns), counted per location
+constexpr std::uint64_t StallLogInterval = 1000 * 1000 * 1000;
+
+// bytes are counted into bins of this width (ns), spread over the time the read was in flight
+constexpr std::uint64_t IoBandwidthBin = 10 * 1000 * 1000;
+
+} // namespace
 
 Monitor::Monitor(QObject *parent)
     : QObject(parent)
-{}
+    , m_ioBandwidthLane(
+          new Lane(QStringLiteral("I/O bandwidth"), QStringLiteral("B/s"), IoBandwidthBin, this))
+    , m_ioInFlightLane(new Lane(QStringLiteral("I/O in flight"), QStringLiteral("reads"), 0, this))
+    , m_frameBytesLane(new Lane(QStringLiteral("Live frame bytes"), QStringLiteral("B"), 0, this))
+    , m_lanes({m_ioBandwidthLane, m_ioInFlightLane})
+{
+    if constexpr (frameallocator::enabled) {
+        m_lanes.push_back(m_frameBytesLane);
+    }
+}
+
+Monitor::~Monitor()
+{
+    logStalls();
+}
 
 QQmlListProperty<Task> Monitor::tasks() const
 {
-    QQmlListProperty<Task> prop(const_cast<Monitor *>(this), &const_cast<Monitor *>(this)->m_tasks);
+    return QQmlListProperty<Task>(
+        const_cast<Monitor *>(this),
+        const_cast<TaskList *>(&m_tasks),
+        [](QQmlListProperty<Task> *prop) {
+            return qsizetype(static_cast<const TaskList *>(prop->data)->size());
+        },
+        [](QQmlListProperty<Task> *prop, qsizetype i) {
+            return static_cast<const TaskList *>(prop->data)->at(i);
+        });
+}
+
+QQmlListProperty<Lane> Monitor::lanes() const
+{
+    QQmlListProperty<Lane> prop(const_cast<Monitor *>(this), &const_cast<Monitor *>(this)->m_lanes);
+    prop.append = nullptr;
+    prop.clear = nullptr;
+    prop.replace = nullptr;
+    prop.removeLast = nullptr;
+    return prop;
+}
+
+QQmlListProperty<IoRead> Monitor::ioReads() const
+{
+    QQmlListProperty<IoRead> prop(const_cast<Monitor *>(this),
+                                  &const_cast<Monitor *>(this)->m_ioReads);
     prop.append = nullptr;
     prop.clear = nullptr;
     prop.replace = nullptr;
@@ -17,6 +69,173 @@ QQmlListProperty<Task> Monitor::tasks() const
     return prop;
 }
 
+QQmlListProperty<LocationStats> Monitor::locations() const
+{
+    QQmlListProperty<LocationStats> prop(const_cast<Monitor *>(this),
+                                         &const_cast<Monitor *>(this)->m_locations);
+    prop.append = nullptr;
+    prop.clear = nullptr;
+    prop.replace = nullptr;
+    prop.removeLast = nullptr;
+    return prop;
+}
+
+LocationStats *Monitor::locationStats(const char *functionName)
+{
+    const auto it = m_locationsByName.find(functionName);
+    if (it != m_locationsByName.end())
+        return it->second;
+
+    auto *stats = new LocationStats(functionName, this);
+    stats->setSnapshotEpoch(m_snapshotEpoch);
+    const auto thresholds = m_stallDetector.thresholds(stats->location());
+    stats->setSuspendedThreshold(thresholds.suspended.count());
+    stats->setResumedThreshold(thresholds.resumed.count());
+    m_locations.push_back(stats);
+    m_locationsByName.emplace(stats->key(), stats);
+    emit locationsChanged();
+    return stats;
+}
+
+Snapshot *Monitor::snapshot()
+{
+    auto *result = new Snapshot(this,
+                                ++m_snapshotEpoch,
+                                m_tasks.snapshot(),
+                                m_locations,
+                                totalEndTime());
+    m_snapshots.push_back(result);
+    QQmlEngine::setObjectOwnership(result, QQmlEngine::JavaScriptOwnership);
+    return result;
+}
+
+void Monitor::releaseSnapshot(Snapshot *snapshot)
+{
+    m_snapshots.removeOne(snapshot);
+}
+
+void Monitor::freeze(Task *task)
+{
+    // only snapshots taken after the last change still see the current state
+    for (auto it = m_snapshots.crbegin();
+         it != m_snapshots.crend() && (*it)->epoch() > task->snapshotEpoch();
+         ++it) {
+        (*it)->freeze(task);
+    }
+    task->setSnapshotEpoch(m_snapshotEpoch);
+}
+
+void Monitor::freeze(LocationStats *stats)
+{
+    for (auto it = m_snapshots.crbegin();
+         it != m_snapshots.crend() && (*it)->epoch() > stats->snapshotEpoch();
+         ++it) {
+        (*it)->freeze(stats);
+    }
+    stats->setSnapshotEpoch(m_snapshotEpoch);
+}
+
+void Monitor::taskStarted(Task *task, TimePoint time)
+{
+    ++m_stateCounts[qsizetype(LogItem::State::Started)];
+    ++m_eventCounts[qsizetype(LogItem::State::Started)];
+    task->locationStats()->taskStarted(task->frameSize());
+    if (task->frameSize() > 0) {
+        m_liveFrameBytes += task->frameSize();
+        m_frameBytesLane->set(time, m_liveFrameBytes);
+    }
+}
+
+void Monitor::taskUpdated(Task *task)
+{
+    const auto &log = task->logList();
+    Q_ASSERT(log.size() >= 2);
+    const LogItem *previous = log[log.size() - 2];
+    const LogItem *current = log.back();
+
+    --m_stateCounts[qsizetype(previous->state())];
+    ++m_stateCounts[qsizetype(current->state())];
+    ++m_eventCounts[qsizetype(current->state())];
+
+    if (previous->hasCpuTime()) {
+        task->locationStats()->addCpuTime(previous->cpuTime(), previous->offCpuTime());
+    }
+    if (previous->hasCounters()) {
+        task->locationStats()->addCounters(previous->counterValues());
+    }
+
+    if (current->state() == LogItem::State::Resumed) {
+        task->locationStats()->observeReadyLatency(previous->endTimeNs() - previous->startTimeNs());
+    } else if (current->state() == LogItem::State::Suspended) {
+        task->locationStats()->countSuspend();
+    }
+}
+
+void Monitor::taskFinished(Task *task, TimePoint time)
+{
+    task->locationStats()->observeWorkTime(task->workTime());
+    task->locationStats()->observeWallTime(task->endTime() - task->startTime());
+    task->locationStats()->taskFinished(task->frameSize());
+    if (task->frameSize() > 0) {
+        m_liveFrameBytes -= task->frameSize();
+        m_frameBytesLane->set(time, m_liveFrameBytes);
+    }
+}
+
+void Monitor::checkStalls(TimePoint time)
+{
+    m_stallDetector.advance(time, [this](Task *task) {
+        preserve(task);
+        task->setStalled(true);
+        ++m_unloggedStalls[task->locationStats()];
+        emit taskStalled(task);
+    });
+
+    // a line per stalled task would flood stderr once a scheduler round outlasts the threshold
+    if (!m_unloggedStalls.empty()
+        && (!m_lastStallLog || time.ns() >= m_lastStallLog->ns() + StallLogInterval)) {
+        logStalls();
+        m_lastStallLog = time;
+    }
+}
+
+void Monitor::logStalls()
+{
+    if (m_unloggedStalls.empty())
+        return;
+
+    QStringList counts;
+    for (const auto &[stats, count] : m_unloggedStalls) {
+        counts.push_back(QStringLiteral("%1 (%2)").arg(stats->location()).arg(count));
+    }
+    counts.sort();
+    qWarning().noquote() << "tasks stalled:" << counts.join(QStringLiteral(", "));
+    m_unloggedStalls.clear();
+}
+
+IoRead *Monitor::beginRead(const QString &path, quint64 bytesRequested, TimePoint time)
+{
+    m_ioInFlightLane->set(time, ++m_readsInFlight);
+
+    auto *read = new IoRead(path, bytesRequested, time, this);
+    m_ioReads.push_back(read);
+    setTotalEndTime(std::max(time, m_totalEndTime.value_or(time)));
+    emit ioReadsChanged();
+    return read;
+}
+
+void Monitor::endRead(IoRead *read, quint64 bytesCompleted, TimePoint time)
+{
+    Q_ASSERT(m_readsInFlight > 0);
+    read->finish(bytesCompleted, time);
+    // O(bins the read was in flight), a long read shows its average rate over its whole duration
+    m_ioBandwidthLane->add(read->startTime(),
+                           time,
+                           qreal(bytesCompleted) * 1e9 / qreal(IoBandwidthBin));
+    m_ioInFlightLane->set(time, --m_readsInFlight);
+    setTotalEndTime(std::max(time, m_totalEndTime.value_or(time)));
+}
+
 namespace {
 
 using Float = qreal;
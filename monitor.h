@@ -3,8 +3,23 @@
 #include <QObject>
 #include <QQmlListProperty>
 #include <QtQmlIntegration>
+#include "chunkedlog.h"
+#include "cputime.h"
+#include "eventpolicy.h"
+#include "frameallocator.h"
+#include "ioitem.h"
+#include "lane.h"
+#include "locationstats.h"
 #include "logitem.h"
+#include "perfcounters.h"
+#include "stalldetector.h"
+#include <QTimer>
 #include <coschedula/scheduler.h>
+#include <array>
+#include <string_view>
+#include <unordered_map>
+
+class Snapshot;
 
 class Task : public QObject
 {
@@ -14,24 +29,60 @@ class Task : public QObject
 
     Q_PROPERTY(bool suspended MEMBER m_suspended NOTIFY suspendedChanged)
     Q_PROPERTY(bool finished MEMBER m_finished NOTIFY finishedChanged)
+    Q_PROPERTY(bool stalled READ stalled NOTIFY stalledChanged)
     Q_PROPERTY(QString location READ location CONSTANT)
+    Q_PROPERTY(LocationStats *locationStats READ locationStats CONSTANT)
+    Q_PROPERTY(quint64 frameSize READ frameSize CONSTANT)
     Q_PROPERTY(quint64 startTime READ startTime WRITE setStartTime NOTIFY startTimeChanged)
     Q_PROPERTY(quint64 endTime READ endTime WRITE setEndTime NOTIFY endTimeChanged)
     Q_PROPERTY(quint64 workTime READ workTime WRITE setWorkTime NOTIFY workTimeChanged)
+    Q_PROPERTY(quint64 cpuTime READ cpuTime NOTIFY cpuTimeChanged)
+    Q_PROPERTY(quint64 offCpuTime READ offCpuTime NOTIFY cpuTimeChanged)
     Q_PROPERTY(QQmlListProperty<LogItem> log READ log NOTIFY logChanged)
 
 public:
     Task(const coschedula::scheduler::task_info &data,
+         std::size_t index,
          TimePoint startTime,
+         LocationStats *locationStats,
+         quint64 frameSize,
          QObject *parent = nullptr)
         : QObject(parent)
         , m_handle(data.h)
         , m_suspended(data.suspended)
-        , m_location(data.loc)
         , m_dep(data.dep)
+        , m_index(index)
+        , m_locationStats(locationStats)
+        , m_frameSize(frameSize)
         , m_log({new LogItem(LogItem::State::Started, startTime, this)})
+        , m_stallEntry(this)
     {}
 
+    /**
+     * @brief Task - frozen copy of `other` for a snapshot. Closed log items never change and are
+     * shared with `other`, only the current one is copied.
+     */
+    Task(const Task &other, LocationStats *locationStats, QObject *parent)
+        : QObject(parent)
+        , m_handle(other.m_handle)
+        , m_suspended(other.m_suspended)
+        , m_dep(other.m_dep)
+        , m_index(other.m_index)
+        , m_locationStats(locationStats)
+        , m_frameSize(other.m_frameSize)
+        , m_finished(other.m_finished)
+        , m_log(other.m_log)
+        , m_startTime(other.m_startTime)
+        , m_endTime(other.m_endTime)
+        , m_workTime(other.m_workTime)
+        , m_cpuTime(other.m_cpuTime)
+        , m_offCpuTime(other.m_offCpuTime)
+        , m_stalled(other.m_stalled)
+        , m_stallEntry(this)
+    {
+        m_log.back() = new LogItem(*other.m_log.back(), this);
+    }
+
     void markFinished()
     {
         if (m_finished)
@@ -39,12 +90,44 @@ public:
         m_finished = true;
         emit finishedChanged();
     }
-    QString location() const { return m_location.function_name(); }
+    bool finished() const { return m_finished; }
+    QString location() const { return m_locationStats->location(); }
+    std::size_t index() const { return m_index; }
+    LocationStats *locationStats() const { return m_locationStats; }
+
+    /**
+     * @brief frameSize - size of the coroutine frame, zero if frame accounting is disabled
+     */
+    quint64 frameSize() const { return m_frameSize; }
     std::coroutine_handle<> handle() const { return m_handle; };
     QQmlListProperty<LogItem> log() const;
 
     const QList<LogItem *> &logList() const { return m_log; };
 
+    /**
+     * @brief stalled - the task is in its current state longer than the stall threshold
+     */
+    bool stalled() const { return m_stalled; }
+
+    void setStalled(bool stalled)
+    {
+        if (m_stalled == stalled)
+            return;
+        m_stalled = stalled;
+        if (stalled) {
+            m_log.back()->setStalled(true);
+        }
+        emit stalledChanged();
+    }
+
+    StallDetector::Wheel::Entry &stallEntry() { return m_stallEntry; }
+
+    /**
+     * @brief snapshotEpoch - epoch of the newest snapshot which has seen the current state, see `Monitor::preserve`
+     */
+    quint64 snapshotEpoch() const { return m_snapshotEpoch; }
+    void setSnapshotEpoch(quint64 epoch) { m_snapshotEpoch = epoch; }
+
     void setSuspended(bool suspended)
     {
         if (m_suspended == suspended)
@@ -53,7 +136,16 @@ public:
         emit suspendedChanged();
     }
 
-    void addLog(LogItem::State state, TimePoint time)
+    /**
+     * @brief addLog - close the current item and start a new one
+     * @param cpu - thread CPU clock at the end of a closed `Resumed` item, splits it into CPU and off-CPU time
+     * @param perf - thread perf counters at the end of a closed `Resumed` item, attributed to it
+     * The start of a `Resumed` item is sampled separately, see `startSlice`.
+     */
+    void addLog(LogItem::State state,
+                TimePoint time,
+                std::optional<ThreadCpuSample> cpu = std::nullopt,
+                std::optional<perfcounters::Sample> perf = std::nullopt)
     {
         if (!m_log.isEmpty()) {
             m_log.back()->setEndTime(time);
@@ -61,14 +153,45 @@ public:
             if (m_log.back()->state() == LogItem::State::Resumed) {
                 const auto duration = m_log.back()->endTimeNs() - m_log.back()->startTimeNs();
                 setWorkTime(workTime() + duration);
+
+                if (cpu && m_lastCpu && cpu->thread == m_lastCpu->thread
+                    && cpu->ns >= m_lastCpu->ns) {
+                    const quint64 sliceCpuTime = std::min<quint64>(cpu->ns - m_lastCpu->ns, duration);
+                    m_log.back()->setCpuTime(sliceCpuTime, duration - sliceCpuTime);
+                    m_cpuTime += sliceCpuTime;
+                    m_offCpuTime += duration - sliceCpuTime;
+                    emit cpuTimeChanged();
+                }
+
+                if (perf && m_lastPerf && perf->thread == m_lastPerf->thread) {
+                    perfcounters::Values slice{};
+                    for (std::size_t i = 0; i < slice.size(); ++i) {
+                        slice[i] = perf->values[i] - std::min(perf->values[i], m_lastPerf->values[i]);
+                    }
+                    m_log.back()->setCounters(slice);
+                }
             }
         }
+        m_lastCpu.reset();
+        m_lastPerf.reset();
         m_log.push_back(new LogItem(state, time, this));
         emit logChanged();
         setStartTime(m_log.isEmpty() ? 0 : m_log.front()->startTimeNs());
         setEndTime(m_log.isEmpty() ? 0 : m_log.back()->endTimeNs());
     }
 
+    /**
+     * @brief startSlice - thread clocks at the start of the current `Resumed` item. `cpu` is taken
+     * with the item's start time, `perf` once the monitor's own bookkeeping for the resume is done
+     * so it is not counted into the slice.
+     */
+    void startSlice(std::optional<ThreadCpuSample> cpu, std::optional<perfcounters::Sample> perf)
+    {
+        Q_ASSERT(!m_log.isEmpty() && m_log.back()->state() == LogItem::State::Resumed);
+        m_lastCpu = cpu;
+        m_lastPerf = perf;
+    }
+
     quint64 startTime() const;
     void setStartTime(quint64 newStartTime);
 
@@ -78,104 +201,298 @@ public:
     quint64 workTime() const;
     void setWorkTime(quint64 newWorkTime);
 
+    /**
+     * @brief cpuTime - CPU time of `Resumed` items which have it, see `LogItem::hasCpuTime`
+     */
+    quint64 cpuTime() const { return m_cpuTime; }
+    quint64 offCpuTime() const { return m_offCpuTime; }
+
 signals:
     void suspendedChanged();
     void finishedChanged();
+    void stalledChanged();
     void logChanged();
     void startTimeChanged();
     void endTimeChanged();
     void workTimeChanged();
+    void cpuTimeChanged();
 
 private:
 private:
     std::coroutine_handle<> m_handle;
     bool m_suspended;
-    coschedula::source_location m_location;
     std::optional<std::coroutine_handle<>> m_dep;
+    std::size_t m_index;
+    LocationStats *m_locationStats;
+    quint64 m_frameSize;
     bool m_finished = false;
     QList<LogItem *> m_log;
     quint64 m_startTime = 0;
     quint64 m_endTime = 0;
     quint64 m_workTime = 0;
+    quint64 m_cpuTime = 0;
+    quint64 m_offCpuTime = 0;
+    std::optional<ThreadCpuSample> m_lastCpu;
+    std::optional<perfcounters::Sample> m_lastPerf;
+    bool m_stalled = false;
+    StallDetector::Wheel::Entry m_stallEntry;
+    quint64 m_snapshotEpoch = 0;
 };
 
+/**
+ * @brief TaskList - every task in start order. Finished tasks never change again, so snapshots
+ * share them with the live model.
+ */
+using TaskList = ChunkedLog<Task *>;
+
 class Monitor : public QObject
 {
     friend TimePoint;
     Q_OBJECT
     QML_ELEMENT
     QML_UNCREATABLE("interface")
+    Q_MOC_INCLUDE("snapshot.h")
 
     Q_PROPERTY(QQmlListProperty<Task> tasks READ tasks NOTIFY tasksChanged)
     Q_PROPERTY(quint64 totalEndTime READ totalEndTime NOTIFY totalEndTimeChanged)
+    Q_PROPERTY(QQmlListProperty<Lane> lanes READ lanes CONSTANT)
+    Q_PROPERTY(QQmlListProperty<IoRead> ioReads READ ioReads NOTIFY ioReadsChanged)
+    Q_PROPERTY(QQmlListProperty<LocationStats> locations READ locations NOTIFY locationsChanged)
 public:
     Monitor(QObject *parent = nullptr);
+    ~Monitor() override;
     QQmlListProperty<Task> tasks() const;
+    QQmlListProperty<Lane> lanes() const;
+    QQmlListProperty<IoRead> ioReads() const;
+    QQmlListProperty<LocationStats> locations() const;
+
+    qsizetype taskCount() const { return m_tasks.size(); }
+
+    /**
+     * @brief liveTaskCount - number of tasks currently in `state`, or all finished ones for `Finished`
+     */
+    quint64 liveTaskCount(LogItem::State state) const { return m_stateCounts[qsizetype(state)]; }
+
+    /**
+     * @brief eventCount - number of events of kind `state` ingested so far
+     */
+    quint64 eventCount(LogItem::State state) const { return m_eventCounts[qsizetype(state)]; }
+
+    const QList<LocationStats *> &locationList() const { return m_locations; }
+
+    /**
+     * @brief setStallOptions - thresholds for locations seen from now on
+     */
+    void setStallOptions(StallDetector::Options options)
+    {
+        m_stallDetector.setOptions(std::move(options));
+    }
 
     quint64 totalEndTime() const { return m_totalEndTime ? m_totalEndTime->ns() : 0; }
 
+    /**
+     * @brief snapshot - frozen view of the tasks ingested so far, O(tasks / chunk size). Tasks still
+     * running and locations are copied lazily, see `Snapshot`.
+     */
+    Q_INVOKABLE Snapshot *snapshot();
+
+    /**
+     * @brief releaseSnapshot - stop preserving state for `snapshot`, called when it is destroyed
+     */
+    void releaseSnapshot(Snapshot *snapshot);
+
     Q_INVOKABLE QPointF scaleAndTrans(qreal currentTrans,
                                       qreal currentScale,
                                       qreal scaleDivision,
                                       qreal wheelPos) const;
 
+    template<typename C>
+    IoRead *beginRead(const QString &path,
+                      quint64 bytesRequested,
+                      std::chrono::time_point<C> timePoint)
+    {
+        return beginRead(path, bytesRequested, makeTimePoint(timePoint));
+    }
+
+    template<typename C>
+    void endRead(IoRead *read, quint64 bytesCompleted, std::chrono::time_point<C> timePoint)
+    {
+        endRead(read, bytesCompleted, makeTimePoint(timePoint));
+    }
+
 signals:
     void tasksChanged();
     void totalEndTimeChanged();
+    void ioReadsChanged();
+    void locationsChanged();
+    void taskStalled(Task *task);
 
 protected:
     template<typename C>
-    void addTask(const coschedula::scheduler::task_info &data, std::chrono::time_point<C> timePoint)
+    void addTask(const coschedula::scheduler::task_info &data,
+                 const char *location,
+                 std::chrono::time_point<C> timePoint)
     {
-        if (!m_startNsTimePoint) {
-            m_startNsTimePoint = TimePoint::nsSinceEpoch(timePoint);
-        }
-
-        m_tasks.push_back(new Task(data, TimePoint(this, timePoint), this));
-        setTotalEndTime(TimePoint(this, timePoint));
+        const auto time = makeTimePoint(timePoint);
+        auto *task = new Task(data,
+                              m_tasks.size(),
+                              time,
+                              locationStats(location),
+                              frameallocator::frameSize(data.h).value_or(0),
+                              this);
+        task->setSnapshotEpoch(m_snapshotEpoch);
+        checkStalls(time);
+        preserve(task->locationStats());
+        taskStarted(task, time);
+        m_tasks.append(task);
+        m_liveTasks[data.h.address()] = task;
+        m_stallDetector.watch(task, time);
+        setTotalEndTime(time);
         emit tasksChanged();
     }
 
+    /**
+     * @brief updateTask - apply `f` to the live task of `h`
+     * @return the task, nullptr if `h` is not a live task
+     */
     template<typename F>
-    void updateTask(std::coroutine_handle<> h, F &&f)
+    Task *updateTask(std::coroutine_handle<> h, TimePoint time, F &&f)
     {
-        const auto it = std::find_if(m_tasks.begin(), m_tasks.end(), [&h](const Task *t) {
-            return t->handle() == h;
-        });
-        if (it != m_tasks.end()) {
-            f(*it);
-            setTotalEndTime((*it)->logList().back()->endTime());
+        checkStalls(time);
+        const auto it = m_liveTasks.find(h.address());
+        if (it != m_liveTasks.end()) {
+            Task *const task = it->second;
+            preserve(task);
+            preserve(task->locationStats());
+            task->setStalled(false);
+            f(task);
+            taskUpdated(task);
+            setTotalEndTime(task->logList().back()->endTime());
+            if (task->finished()) {
+                taskFinished(task, time);
+                m_stallDetector.unwatch(task);
+                // the frame address may be reused by the next coroutine
+                m_liveTasks.erase(it);
+            } else {
+                m_stallDetector.watch(task, time);
+            }
+            return task;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief preserve - hand the current state of `task` to snapshots taken since it last changed,
+     * right before changing it. O(1) unless a snapshot was taken in between.
+     */
+    void preserve(Task *task)
+    {
+        if (task->snapshotEpoch() != m_snapshotEpoch) {
+            freeze(task);
+        }
+    }
+
+    void preserve(LocationStats *stats)
+    {
+        if (stats->snapshotEpoch() != m_snapshotEpoch) {
+            freeze(stats);
+        }
+    }
+
+    template<typename C>
+    void checkStalls(std::chrono::time_point<C> timePoint)
+    {
+        if (m_startNsTimePoint) {
+            checkStalls(TimePoint(this, timePoint));
         }
     }
 
 private:
+    template<typename C>
+    TimePoint makeTimePoint(std::chrono::time_point<C> timePoint)
+    {
+        if (!m_startNsTimePoint) {
+            m_startNsTimePoint = TimePoint::nsSinceEpoch(timePoint);
+        }
+        return TimePoint(this, timePoint);
+    }
+
+    LocationStats *locationStats(const char *functionName);
+    void freeze(Task *task);
+    void freeze(LocationStats *stats);
+    void taskStarted(Task *task, TimePoint time);
+    void taskUpdated(Task *task);
+    void taskFinished(Task *task, TimePoint time);
+    void checkStalls(TimePoint time);
+    void logStalls();
+
+    IoRead *beginRead(const QString &path, quint64 bytesRequested, TimePoint time);
+    void endRead(IoRead *read, quint64 bytesCompleted, TimePoint time);
+
     void setTotalEndTime(TimePoint time)
     {
         if (m_totalEndTime == time)
             return;
 
         m_totalEndTime = time;
+        for (Lane *lane : std::as_const(m_lanes)) {
+            lane->extend(time);
+        }
         emit totalEndTimeChanged();
     }
 
 private:
-    QList<Task *> m_tasks;
+    TaskList m_tasks;
+    std::unordered_map<void *, Task *> m_liveTasks;
+    StallDetector m_stallDetector;
+    std::array<quint64, 4> m_stateCounts{};
+    std::array<quint64, 4> m_eventCounts{};
     std::optional<std::uint64_t> m_startNsTimePoint;
     std::optional<TimePoint> m_totalEndTime;
+
+    QList<IoRead *> m_ioReads;
+    std::size_t m_readsInFlight = 0;
+    Lane *m_ioBandwidthLane;
+    Lane *m_ioInFlightLane;
+    Lane *m_frameBytesLane;
+    QList<Lane *> m_lanes;
+
+    QList<LocationStats *> m_locations;
+    std::unordered_map<std::string_view, LocationStats *> m_locationsByName;
+    quint64 m_liveFrameBytes = 0;
+
+    // incremented by every snapshot, live snapshots in epoch order
+    quint64 m_snapshotEpoch = 0;
+    QList<Snapshot *> m_snapshots;
+
+    // stalls since the last log line, per location
+    std::unordered_map<const LocationStats *, quint64> m_unloggedStalls;
+    std::optional<TimePoint> m_lastStallLog;
 };
 Q_DECLARE_INTERFACE(Monitor, "appcoschedula_monitor.Monitor")
 
-template<std::derived_from<coschedula::scheduler> T>
-class MonitorImpl : public Monitor, public coschedula::scheduler::subscriber
+/**
+ * @brief The ModelSink class - event sink which builds the Qt model behind the UI
+ */
+class ModelSink : public Monitor
 {
-    //QML_ELEMENT
     using Clock = std::chrono::high_resolution_clock;
 
 public:
-    MonitorImpl(QObject *parent = nullptr)
+    /**
+     * @brief accepts - the Qt model needs at least started and finished events with timestamps and locations
+     */
+    template<typename Policy>
+    static constexpr bool accepts = Policy::started && Policy::finished && Policy::timestamps
+                                    && Policy::locations;
+
+    ModelSink(QObject *parent = nullptr)
         : Monitor(parent)
     {
-        coschedula::scheduler::instance<T>.install_subscriber(*this);
+        // deadlines of tasks which produce no more events still have to expire
+        auto *stallTimer = new QTimer(this);
+        connect(stallTimer, &QTimer::timeout, this, [this] { checkStalls(Clock::now()); });
+        stallTimer->start(50);
 
         //QTimer *timer = new QTimer(this);
         //connect(timer, &QTimer::timeout, this, [this] {
@@ -191,34 +508,86 @@ public:
         //timer->start(1000 / 60);
     }
 
-    // subscriber interface
-public:
-    void task_started(const coschedula::scheduler::task_info &info) override
+    template<typename E>
+    void onStarted(const E &event)
     {
-        addTask(info, Clock::now());
+        addTask(event.info, event.location, event.time);
     }
 
-    void task_finished(const coschedula::scheduler::task_info &info) override
+    template<typename E>
+    void onFinished(const E &event)
     {
-        updateTask(info.h, [time = TimePoint(this, Clock::now())](Task *task) {
+        const auto sample = threadSample(event);
+        const auto time = TimePoint(this, event.time);
+        updateTask(event.info.h, time, [time, sample](Task *task) {
             task->markFinished();
-            task->addLog(LogItem::State::Finished, time);
+            task->addLog(LogItem::State::Finished, time, sample.cpu, sample.perf);
         });
     }
 
-    void task_suspended(const coschedula::scheduler::task_info &info) override
+    template<typename E>
+    void onSuspended(const E &event)
     {
-        updateTask(info.h, [time = TimePoint(this, Clock::now())](Task *task) {
+        const auto sample = threadSample(event);
+        const auto time = TimePoint(this, event.time);
+        updateTask(event.info.h, time, [time, sample](Task *task) {
             task->setSuspended(true);
-            task->addLog(LogItem::State::Suspended, time);
+            task->addLog(LogItem::State::Suspended, time, sample.cpu, sample.perf);
         });
     }
 
-    void task_resumed(const coschedula::scheduler::task_info &info) override
+    template<typename E>
+    void onResumed(const E &event)
     {
-        updateTask(info.h, [time = TimePoint(this, Clock::now())](Task *task) {
+        const auto time = TimePoint(this, event.time);
+        Task *const task = updateTask(event.info.h, time, [time](Task *task) {
             task->setSuspended(false);
             task->addLog(LogItem::State::Resumed, time);
         });
+        if constexpr (hasThreadSample<E>) {
+            // the CPU clock was read with the timestamp, the counters are read last so that they
+            // leave out the bookkeeping above
+            if (task) {
+                task->startSlice(event.thread.cpu, perfcounters::now());
+            }
+        }
+    }
+
+private:
+    template<typename E>
+    static constexpr bool hasThreadSample
+        = std::same_as<std::remove_cvref_t<decltype(std::declval<E>().thread)>, ThreadSample>;
+
+    /**
+     * @brief threadSample - sample taken by `MonitorImpl` before the event's timestamp, if the policy asks for it
+     */
+    template<typename E>
+    static ThreadSample threadSample(const E &event)
+    {
+        if constexpr (hasThreadSample<E>) {
+            return event.thread;
+        } else {
+            return {};
+        }
     }
 };
+
+/**
+ * @brief The ModelPolicy struct - everything recorded into the Qt model
+ */
+struct ModelPolicy
+{
+    static constexpr bool started = true;
+    static constexpr bool suspended = true;
+    static constexpr bool resumed = true;
+    static constexpr bool finished = true;
+    static constexpr bool locations = true;
+    static constexpr bool timestamps = true;
+    static constexpr bool threadSamples = true;
+    using Sink = ModelSink;
+};
+
+// the Qt model is the default sink of `MonitorImpl`
+template<std::derived_from<coschedula::scheduler> T, typename Policy = ModelPolicy>
+    requires EventSink<typename Policy::Sink, Policy>
+class MonitorImpl;
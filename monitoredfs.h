@@ -0,0 +1,46 @@
+#pragma once
+
+#include "monitor.h"
+
+#include <chrono>
+#include <coschedula/fs.h>
+#include <coschedula/task.h>
+#include <filesystem>
+#include <string>
+
+namespace monitored::fs {
+
+/**
+ * @brief read - `coschedula::fs::read` which reports bytes requested and completed,
+ * time in flight and achieved throughput to `monitor`
+ */
+template<typename C, typename E>
+coschedula::task<std::basic_string<C>, coschedula::scheduler> read(Monitor &monitor,
+                                                                   std::filesystem::path path)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    IoRead *const io = monitor.beginRead(QString::fromStdString(path.string()),
+                                         ec ? 0 : size,
+                                         Clock::now());
+
+    // ends the read even if it throws or the coroutine is destroyed, with what completed so far
+    struct EndRead
+    {
+        Monitor &monitor;
+        IoRead *io;
+        quint64 bytesCompleted = 0;
+
+        ~EndRead() { monitor.endRead(io, bytesCompleted, Clock::now()); }
+    } endRead{monitor, io};
+
+    const auto task = coschedula::fs::read<C, E>(path);
+    auto result = co_await task;
+
+    endRead.bytesCompleted = result.size() * sizeof(C);
+    co_return result;
+}
+
+} // namespace monitored::fs
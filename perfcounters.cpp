@@ -0,0 +1,240 @@
+#include "perfcounters.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perfcounters {
+
+namespace {
+
+std::atomic<Mode> s_mode = Mode::Disabled;
+
+constexpr std::array<const char *, 4> HardwareNames = {"cycles",
+                                                       "instructions",
+                                                       "cache-misses",
+                                                       "branch-misses"};
+constexpr std::array<const char *, 3> SoftwareNames = {"task-clock",
+                                                       "context-switches",
+                                                       "page-faults"};
+
+#ifdef __linux__
+
+struct Event
+{
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::array<Event, 4> HardwareEvents = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+constexpr std::array<Event, 3> SoftwareEvents = {{
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+}};
+
+/**
+ * @brief The Group class - counter group of one thread, read with a single `read` call
+ */
+class Group
+{
+public:
+    Group() = default;
+    Group(const Group &) = delete;
+    Group &operator=(const Group &) = delete;
+
+    ~Group() { close(); }
+
+    bool open(std::span<const Event> events)
+    {
+        close();
+        // kernel side counting is refused with perf_event_paranoid >= 2, retry user space only
+        for (const bool excludeKernel : {false, true}) {
+            if (openGroup(events, excludeKernel))
+                return true;
+            close();
+        }
+        return false;
+    }
+
+    bool isOpen() const { return m_count > 0; }
+
+    /**
+     * @brief read - current values, scaled up if the group was multiplexed with other events
+     * @param running - set to the time the group was actually counting
+     */
+    std::optional<Values> read(std::uint64_t *running = nullptr) const
+    {
+        // PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING layout
+        struct
+        {
+            std::uint64_t count;
+            std::uint64_t enabled;
+            std::uint64_t running;
+            std::uint64_t values[MaxCounters];
+        } data;
+
+        const auto size = ::read(m_fds[0], &data, sizeof(data));
+        if (size < 0 || std::size_t(size) < 3 * sizeof(std::uint64_t) || data.count != m_count)
+            return std::nullopt;
+
+        Values result{};
+        for (std::size_t i = 0; i < m_count; ++i) {
+            result[i] = data.running > 0 && data.running < data.enabled
+                            ? std::uint64_t(double(data.values[i]) * data.enabled / data.running)
+                            : data.values[i];
+        }
+        if (running) {
+            *running = data.running;
+        }
+        return result;
+    }
+
+private:
+    bool openGroup(std::span<const Event> events, bool excludeKernel)
+    {
+        for (const Event &event : events) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = m_count == 0;
+            attr.exclude_kernel = excludeKernel;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                               | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int leader = m_count == 0 ? -1 : m_fds[0];
+            const int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0)
+                return false;
+            m_fds[m_count++] = fd;
+        }
+        return ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == 0;
+    }
+
+    void close()
+    {
+        for (std::size_t i = 0; i < m_count; ++i) {
+            ::close(m_fds[i]);
+        }
+        m_count = 0;
+    }
+
+private:
+    std::array<int, MaxCounters> m_fds{};
+    std::size_t m_count = 0;
+};
+
+std::span<const Event> events(Mode mode)
+{
+    switch (mode) {
+    case Mode::Hardware:
+        return HardwareEvents;
+    case Mode::Software:
+        return SoftwareEvents;
+    case Mode::Disabled:
+        break;
+    }
+    return {};
+}
+
+/**
+ * @brief threadGroup - group of the calling thread, opened on first use in the current mode
+ */
+Group *threadGroup(Mode mode)
+{
+    thread_local Group group;
+    thread_local bool opened = false;
+    if (!opened) {
+        opened = true;
+        group.open(events(mode));
+    }
+    return group.isOpen() ? &group : nullptr;
+}
+
+/**
+ * @brief hardwareCounts - hardware counters can be opened but never scheduled, e.g. in VMs without a virtual PMU
+ */
+bool hardwareCounts(const Group &group)
+{
+    volatile std::uint64_t sink = 0;
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        sink = sink + i;
+    }
+
+    std::uint64_t running = 0;
+    const auto values = group.read(&running);
+    return values && running > 0 && (*values)[0] > 0;
+}
+
+#endif
+
+} // namespace
+
+Mode enable()
+{
+#ifdef __linux__
+    Group probe;
+    if (probe.open(HardwareEvents) && hardwareCounts(probe)) {
+        s_mode = Mode::Hardware;
+    } else if (probe.open(SoftwareEvents)) {
+        s_mode = Mode::Software;
+    } else {
+        s_mode = Mode::Disabled;
+    }
+#endif
+    return s_mode;
+}
+
+Mode mode()
+{
+    return s_mode.load(std::memory_order_relaxed);
+}
+
+std::span<const char *const> names()
+{
+    switch (mode()) {
+    case Mode::Hardware:
+        return HardwareNames;
+    case Mode::Software:
+        return SoftwareNames;
+    case Mode::Disabled:
+        break;
+    }
+    return {};
+}
+
+std::optional<Sample> now()
+{
+#ifdef __linux__
+    const Mode mode = perfcounters::mode();
+    if (mode == Mode::Disabled)
+        return std::nullopt;
+
+    const Group *group = threadGroup(mode);
+    if (!group)
+        return std::nullopt;
+
+    const auto values = group->read();
+    if (!values)
+        return std::nullopt;
+    return Sample{std::hash<std::thread::id>{}(std::this_thread::get_id()), *values};
+#else
+    return std::nullopt;
+#endif
+}
+
+} // namespace perfcounters
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+/**
+ * Opt-in per-thread `perf_event_open` counters, enabled with `--perf-counters`, Linux only.
+ * Hardware counters (cycles, instructions, cache misses, branch misses) are used where the PMU is
+ * accessible, otherwise software events (task clock, context switches, page faults), which
+ * most containers still allow. Each thread opens its own counter group on its first sample.
+ */
+namespace perfcounters {
+
+enum class Mode { Disabled, Hardware, Software };
+
+inline constexpr std::size_t MaxCounters = 4;
+
+using Values = std::array<std::uint64_t, MaxCounters>;
+
+/**
+ * @brief The Sample struct - reading of the calling thread's counter group.
+ * Like `ThreadCpuSample`, two samples are only comparable if they were taken on the same thread.
+ */
+struct Sample
+{
+    std::size_t thread = 0;
+    Values values{};
+};
+
+/**
+ * @brief enable - probe hardware counters, then software events, on the calling thread
+ * @return the mode every thread samples in from now on, `Disabled` if neither can be opened
+ */
+Mode enable();
+
+Mode mode();
+
+/**
+ * @brief names - names of the counters of the current mode, in `Sample::values` order
+ */
+std::span<const char *const> names();
+
+/**
+ * @brief now - sample the calling thread's counters, nullopt if disabled or not available on this thread
+ */
+std::optional<Sample> now();
+
+} // namespace perfcounters
@@ -0,0 +1,95 @@
+#include "snapshot.h"
+
+Snapshot::Snapshot(Monitor *monitor,
+                   quint64 epoch,
+                   TaskList::Snapshot tasks,
+                   const QList<LocationStats *> &locations,
+                   quint64 totalEndTime,
+                   QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+    , m_epoch(epoch)
+    , m_tasks(std::move(tasks))
+    , m_locations(locations)
+    , m_totalEndTime(totalEndTime)
+{}
+
+Snapshot::~Snapshot()
+{
+    if (m_monitor) {
+        m_monitor->releaseSnapshot(this);
+    }
+}
+
+QQmlListProperty<Task> Snapshot::tasks() const
+{
+    return QQmlListProperty<Task>(
+        const_cast<Snapshot *>(this),
+        nullptr,
+        [](QQmlListProperty<Task> *prop) {
+            return qsizetype(static_cast<const Snapshot *>(prop->object)->taskCount());
+        },
+        [](QQmlListProperty<Task> *prop, qsizetype i) {
+            return static_cast<const Snapshot *>(prop->object)->task(i);
+        });
+}
+
+QQmlListProperty<LocationStats> Snapshot::locations() const
+{
+    return QQmlListProperty<LocationStats>(
+        const_cast<Snapshot *>(this),
+        nullptr,
+        [](QQmlListProperty<LocationStats> *prop) {
+            return static_cast<const Snapshot *>(prop->object)->m_locations.size();
+        },
+        [](QQmlListProperty<LocationStats> *prop, qsizetype i) {
+            const auto *snapshot = static_cast<const Snapshot *>(prop->object);
+            const LocationStats *live = snapshot->m_locations[i];
+            snapshot->freeze(live);
+            return snapshot->m_frozenLocations.at(live);
+        });
+}
+
+Task *Snapshot::task(std::size_t i) const
+{
+    Task *const live = m_tasks.at(i);
+    // not changed since the snapshot was taken, otherwise the monitor would have frozen it
+    if (!live->finished()) {
+        freeze(live);
+    }
+    const auto it = m_frozenTasks.find(i);
+    return it != m_frozenTasks.end() ? it->second : live;
+}
+
+LocationStats *Snapshot::locationStats(Task *task) const
+{
+    if (!task)
+        return nullptr;
+
+    LocationStats *const stats = task->locationStats();
+    if (stats->parent() == this)
+        return stats;
+
+    freeze(stats);
+    return m_frozenLocations.at(stats);
+}
+
+void Snapshot::freeze(const Task *task) const
+{
+    Q_ASSERT(task->index() < m_tasks.size());
+    if (m_frozenTasks.contains(task->index()))
+        return;
+
+    freeze(task->locationStats());
+    auto *const self = const_cast<Snapshot *>(this);
+    m_frozenTasks.emplace(task->index(),
+                          new Task(*task, m_frozenLocations.at(task->locationStats()), self));
+}
+
+void Snapshot::freeze(const LocationStats *stats) const
+{
+    if (m_frozenLocations.contains(stats))
+        return;
+
+    m_frozenLocations.emplace(stats, new LocationStats(*stats, const_cast<Snapshot *>(this)));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "monitor.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QQmlListProperty>
+#include <QtQmlIntegration>
+#include <unordered_map>
+
+/**
+ * @brief The Snapshot class - frozen view of the tasks at the time `Monitor::snapshot` was called.
+ * Taking one copies nothing but references to the chunks of the task list. Finished tasks never
+ * change again and are shared with the live model. A task still running, or a location, is copied
+ * copy-on-write: by the monitor right before it first changes after the snapshot was taken, or by
+ * the snapshot when it is first read, whichever comes first.
+ */
+class Snapshot : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created by Monitor only")
+
+    Q_PROPERTY(QQmlListProperty<Task> tasks READ tasks CONSTANT)
+    Q_PROPERTY(QQmlListProperty<LocationStats> locations READ locations CONSTANT)
+    Q_PROPERTY(quint64 totalEndTime READ totalEndTime CONSTANT)
+    Q_PROPERTY(quint64 taskCount READ taskCount CONSTANT)
+public:
+    Snapshot(Monitor *monitor,
+             quint64 epoch,
+             TaskList::Snapshot tasks,
+             const QList<LocationStats *> &locations,
+             quint64 totalEndTime,
+             QObject *parent = nullptr);
+    ~Snapshot() override;
+
+    QQmlListProperty<Task> tasks() const;
+    QQmlListProperty<LocationStats> locations() const;
+    quint64 totalEndTime() const { return m_totalEndTime; }
+    quint64 taskCount() const { return m_tasks.size(); }
+
+    /**
+     * @brief epoch - snapshots taken from the same monitor have increasing epochs
+     */
+    quint64 epoch() const { return m_epoch; }
+
+    /**
+     * @brief task - the `i`th task as it was when the snapshot was taken
+     */
+    Task *task(std::size_t i) const;
+
+    /**
+     * @brief locationStats - frozen aggregates of the location of `task`. Shared finished tasks
+     * still point at the live ones.
+     */
+    Q_INVOKABLE LocationStats *locationStats(Task *task) const;
+
+    /**
+     * @brief freeze - copy the live `task` unless already done, called by the monitor right before
+     * it changes
+     */
+    void freeze(const Task *task) const;
+    void freeze(const LocationStats *stats) const;
+
+private:
+    QPointer<Monitor> m_monitor;
+    quint64 m_epoch;
+    TaskList::Snapshot m_tasks;
+    QList<LocationStats *> m_locations;
+    quint64 m_totalEndTime;
+    // copies made so far, keyed by task index and by live location
+    mutable std::unordered_map<std::size_t, Task *> m_frozenTasks;
+    mutable std::unordered_map<const LocationStats *, LocationStats *> m_frozenLocations;
+};
@@ -0,0 +1,95 @@
+#include "stalldetector.h"
+#include "duration.h"
+#include "monitor.h"
+
+void StallDetector::addOptions(QCommandLineParser &parser)
+{
+    parser.addOptions({
+        {QStringLiteral("stall-suspended"),
+         QStringLiteral("Flag tasks suspended longer than this, 0ns disables."),
+         QStringLiteral("duration"),
+         QStringLiteral("1s")},
+        {QStringLiteral("stall-resumed"),
+         QStringLiteral("Flag tasks resumed longer than this, 0ns disables."),
+         QStringLiteral("duration"),
+         QStringLiteral("100ms")},
+        {QStringLiteral("stall"),
+         QStringLiteral("Thresholds for locations containing <pattern>: <pattern>=<suspended>,<resumed>. "
+                        "May be repeated, the first matching rule wins."),
+         QStringLiteral("rule")},
+    });
+}
+
+std::optional<StallDetector::Options> StallDetector::parseOptions(const QCommandLineParser &parser,
+                                                                  QString *error)
+{
+    Options result;
+
+    const auto suspended = parseDuration(parser.value(QStringLiteral("stall-suspended")));
+    const auto resumed = parseDuration(parser.value(QStringLiteral("stall-resumed")));
+    if (!suspended || !resumed) {
+        *error = QStringLiteral("invalid --stall-suspended or --stall-resumed");
+        return std::nullopt;
+    }
+    result.defaults = {*suspended, *resumed};
+
+    for (const auto &rule : parser.values(QStringLiteral("stall"))) {
+        // function names contain `::` and `,` only inside templates, so split on the last ones
+        const auto eq = rule.lastIndexOf(QLatin1Char('='));
+        const auto comma = rule.lastIndexOf(QLatin1Char(','));
+        if (eq <= 0 || comma < eq) {
+            *error = QStringLiteral("invalid --stall: %1").arg(rule);
+            return std::nullopt;
+        }
+
+        const auto ruleSuspended = parseDuration(rule.mid(eq + 1, comma - eq - 1));
+        const auto ruleResumed = parseDuration(rule.mid(comma + 1));
+        if (!ruleSuspended || !ruleResumed) {
+            *error = QStringLiteral("invalid --stall: %1").arg(rule);
+            return std::nullopt;
+        }
+        result.rules.push_back({rule.left(eq), {*ruleSuspended, *ruleResumed}});
+    }
+    return result;
+}
+
+StallDetector::StallDetector()
+    : m_wheel(Tick)
+{}
+
+StallDetector::Thresholds StallDetector::thresholds(const QString &location) const
+{
+    for (const auto &rule : m_options.rules) {
+        if (location.contains(rule.pattern))
+            return rule.thresholds;
+    }
+    return m_options.defaults;
+}
+
+void StallDetector::watch(Task *task, TimePoint time)
+{
+    const LocationStats *stats = task->locationStats();
+    quint64 threshold = 0;
+    switch (task->logList().back()->state()) {
+    case LogItem::State::Started:
+    case LogItem::State::Suspended:
+        threshold = stats->suspendedThreshold();
+        break;
+    case LogItem::State::Resumed:
+        threshold = stats->resumedThreshold();
+        break;
+    case LogItem::State::Finished:
+        break;
+    }
+
+    if (threshold == 0) {
+        m_wheel.cancel(task->stallEntry());
+        return;
+    }
+    m_wheel.schedule(task->stallEntry(), time.ns() + threshold);
+}
+
+void StallDetector::unwatch(Task *task)
+{
+    m_wheel.cancel(task->stallEntry());
+}
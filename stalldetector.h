@@ -0,0 +1,82 @@
+#pragma once
+
+#include "logitem.h"
+#include "timerwheel.h"
+
+#include <QCommandLineParser>
+#include <QList>
+#include <chrono>
+#include <optional>
+
+class Task;
+
+/**
+ * @brief The StallDetector class - watchdog over the current state of every live task.
+ * Each state change (re)schedules the task's deadline in a timer wheel, so there is no periodic
+ * scan over tasks: only the deadlines that actually expire are visited.
+ */
+class StallDetector
+{
+public:
+    /**
+     * @brief The Thresholds struct - how long a task may stay in a state, zero disables the check.
+     * `Started` counts as suspended since the task is waiting to be resumed.
+     */
+    struct Thresholds
+    {
+        std::chrono::nanoseconds suspended{0};
+        std::chrono::nanoseconds resumed{0};
+    };
+
+    /**
+     * @brief The Rule struct - thresholds for locations containing `pattern`
+     */
+    struct Rule
+    {
+        QString pattern;
+        Thresholds thresholds;
+    };
+
+    struct Options
+    {
+        Thresholds defaults{std::chrono::seconds(1), std::chrono::milliseconds(100)};
+        QList<Rule> rules;
+    };
+
+    using Wheel = TimerWheel<Task>;
+
+    static void addOptions(QCommandLineParser &parser);
+    static std::optional<Options> parseOptions(const QCommandLineParser &parser, QString *error);
+
+    StallDetector();
+
+    void setOptions(Options options) { m_options = std::move(options); }
+
+    /**
+     * @brief thresholds - thresholds of the first rule matching `location`, defaults otherwise
+     */
+    Thresholds thresholds(const QString &location) const;
+
+    /**
+     * @brief watch - schedule the deadline of the current state of `task`, entered at `time`
+     */
+    void watch(Task *task, TimePoint time);
+
+    void unwatch(Task *task);
+
+    /**
+     * @brief advance - call `stalled(Task *)` for every task whose deadline expired by `time`
+     */
+    template<typename F>
+    void advance(TimePoint time, F &&stalled)
+    {
+        m_wheel.advance(time.ns(), [&stalled](Wheel::Entry &entry) { stalled(entry.value()); });
+    }
+
+private:
+    // deadlines are rounded up to this granularity
+    static constexpr std::uint64_t Tick = 100 * 1000;
+
+    Options m_options;
+    Wheel m_wheel;
+};
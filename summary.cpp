@@ -0,0 +1,116 @@
+#include "summary.h"
+#include "monitor.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <cmath>
+
+Summary::Distribution Summary::Distribution::of(const Histogram &histogram)
+{
+    return {histogram.count(),
+            histogram.sum(),
+            std::sqrt(histogram.variance()),
+            histogram.quantile(0.1),
+            histogram.quantile(0.5),
+            histogram.quantile(0.9),
+            histogram.quantile(0.99)};
+}
+
+QJsonObject Summary::Distribution::toJson() const
+{
+    // JSON numbers are doubles, ns sums stay exact up to ~104 days
+    return {{QStringLiteral("count"), double(count)},
+            {QStringLiteral("sum"), double(sum)},
+            {QStringLiteral("stddev"), stddev},
+            {QStringLiteral("p10"), p10},
+            {QStringLiteral("p50"), p50},
+            {QStringLiteral("p90"), p90},
+            {QStringLiteral("p99"), p99}};
+}
+
+Summary::Distribution Summary::Distribution::fromJson(const QJsonObject &json)
+{
+    return {quint64(json.value(QStringLiteral("count")).toDouble()),
+            quint64(json.value(QStringLiteral("sum")).toDouble()),
+            json.value(QStringLiteral("stddev")).toDouble(),
+            json.value(QStringLiteral("p10")).toDouble(),
+            json.value(QStringLiteral("p50")).toDouble(),
+            json.value(QStringLiteral("p90")).toDouble(),
+            json.value(QStringLiteral("p99")).toDouble()};
+}
+
+Summary Summary::of(const Monitor &monitor)
+{
+    Summary result;
+    for (const LocationStats *stats : monitor.locationList()) {
+        result.locations.push_back({stats->location(),
+                                    stats->taskCount(),
+                                    stats->suspendCount(),
+                                    Distribution::of(stats->workTime()),
+                                    Distribution::of(stats->wallTime()),
+                                    Distribution::of(stats->readyLatency())});
+    }
+    return result;
+}
+
+bool Summary::save(const QString &path, QString *error) const
+{
+    QJsonArray locationsJson;
+    for (const Location &location : locations) {
+        locationsJson.append(QJsonObject{
+            {QStringLiteral("location"), location.location},
+            {QStringLiteral("tasks"), double(location.taskCount)},
+            {QStringLiteral("suspends"), double(location.suspendCount)},
+            {QStringLiteral("workTime"), location.workTime.toJson()},
+            {QStringLiteral("wallTime"), location.wallTime.toJson()},
+            {QStringLiteral("readyLatency"), location.readyLatency.toJson()},
+        });
+    }
+    const QJsonObject json{{QStringLiteral("version"), Version},
+                           {QStringLiteral("locations"), locationsJson}};
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(QJsonDocument(json).toJson(QJsonDocument::Indented)) < 0) {
+        *error = QStringLiteral("failed to write %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+std::optional<Summary> Summary::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QStringLiteral("failed to read %1: %2").arg(path, file.errorString());
+        return std::nullopt;
+    }
+
+    QJsonParseError parseError;
+    const auto document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        *error = QStringLiteral("invalid summary %1: %2").arg(path, parseError.errorString());
+        return std::nullopt;
+    }
+
+    const auto json = document.object();
+    if (json.value(QStringLiteral("version")).toInt() != Version) {
+        *error = QStringLiteral("unsupported summary version in %1").arg(path);
+        return std::nullopt;
+    }
+
+    Summary result;
+    for (const auto &value : json.value(QStringLiteral("locations")).toArray()) {
+        const auto location = value.toObject();
+        result.locations.push_back({
+            location.value(QStringLiteral("location")).toString(),
+            quint64(location.value(QStringLiteral("tasks")).toDouble()),
+            quint64(location.value(QStringLiteral("suspends")).toDouble()),
+            Distribution::fromJson(location.value(QStringLiteral("workTime")).toObject()),
+            Distribution::fromJson(location.value(QStringLiteral("wallTime")).toObject()),
+            Distribution::fromJson(location.value(QStringLiteral("readyLatency")).toObject()),
+        });
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "histogram.h"
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <optional>
+
+class Monitor;
+
+/**
+ * @brief The Summary struct - compact per-location summary of a monitor session.
+ * Saved as JSON with `--save-summary` and compared between runs by `SummaryDiff`. Times are in ns.
+ */
+struct Summary
+{
+    /**
+     * @brief The Distribution struct - count, sum, standard deviation and quantile estimates of a `Histogram`
+     */
+    struct Distribution
+    {
+        quint64 count = 0;
+        quint64 sum = 0;
+        double stddev = 0;
+        double p10 = 0;
+        double p50 = 0;
+        double p90 = 0;
+        double p99 = 0;
+
+        double mean() const { return count > 0 ? double(sum) / double(count) : 0; }
+
+        static Distribution of(const Histogram &histogram);
+        QJsonObject toJson() const;
+        static Distribution fromJson(const QJsonObject &json);
+    };
+
+    struct Location
+    {
+        QString location;
+        quint64 taskCount = 0;
+        quint64 suspendCount = 0;
+        Distribution workTime;
+        Distribution wallTime;
+        Distribution readyLatency;
+    };
+
+    static constexpr int Version = 2;
+
+    QList<Location> locations;
+
+    static Summary of(const Monitor &monitor);
+
+    bool save(const QString &path, QString *error) const;
+    static std::optional<Summary> load(const QString &path, QString *error);
+};
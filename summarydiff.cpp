@@ -0,0 +1,141 @@
+#include "summarydiff.h"
+
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+QString formatTime(double ns)
+{
+    if (ns < 1000) {
+        return QStringLiteral("%1 ns").arg(ns, 0, 'f', 0);
+    } else if (ns < 1000 * 1000) {
+        return QStringLiteral("%1 us").arg(ns / 1000, 0, 'f', 1);
+    } else if (ns < 1000 * 1000 * 1000) {
+        return QStringLiteral("%1 ms").arg(ns / 1000 / 1000, 0, 'f', 1);
+    } else {
+        return QStringLiteral("%1 s").arg(ns / 1000 / 1000 / 1000, 0, 'f', 2);
+    }
+}
+
+} // namespace
+
+SummaryDiffEntry::SummaryDiffEntry(const QString &location,
+                                   const QString &metric,
+                                   const Summary::Distribution &baseline,
+                                   const Summary::Distribution &candidate,
+                                   double threshold,
+                                   QObject *parent)
+    : QObject(parent)
+    , m_location(location)
+    , m_metric(metric)
+    , m_baseline(baseline)
+    , m_candidate(candidate)
+    , m_diff(MeanDiff::compare({baseline.count, baseline.mean(), baseline.stddev},
+                               {candidate.count, candidate.mean(), candidate.stddev}))
+    , m_threshold(threshold)
+{}
+
+SummaryDiff::SummaryDiff(const Summary &baseline,
+                         const Summary &candidate,
+                         double threshold,
+                         QObject *parent)
+    : QObject(parent)
+    , m_threshold(threshold)
+{
+    QHash<QString, const Summary::Location *> baselineByName;
+    for (const auto &location : baseline.locations) {
+        baselineByName.insert(location.location, &location);
+    }
+
+    for (const auto &location : candidate.locations) {
+        const Summary::Location *base = baselineByName.take(location.location);
+        if (!base) {
+            m_addedLocations.push_back(location.location);
+            continue;
+        }
+
+        m_entries.push_back(new SummaryDiffEntry(location.location,
+                                                 QStringLiteral("work time"),
+                                                 base->workTime,
+                                                 location.workTime,
+                                                 threshold,
+                                                 this));
+        m_entries.push_back(new SummaryDiffEntry(location.location,
+                                                 QStringLiteral("wall time"),
+                                                 base->wallTime,
+                                                 location.wallTime,
+                                                 threshold,
+                                                 this));
+        m_entries.push_back(new SummaryDiffEntry(location.location,
+                                                 QStringLiteral("ready latency"),
+                                                 base->readyLatency,
+                                                 location.readyLatency,
+                                                 threshold,
+                                                 this));
+    }
+    // keep the baseline order for removed locations
+    for (const auto &location : baseline.locations) {
+        if (baselineByName.contains(location.location)) {
+            m_removedLocations.push_back(location.location);
+        }
+    }
+
+    std::stable_sort(m_entries.begin(),
+                     m_entries.end(),
+                     [](const SummaryDiffEntry *a, const SummaryDiffEntry *b) {
+                         return MeanDiff::ranksBefore(a->diff(), b->diff());
+                     });
+}
+
+QQmlListProperty<SummaryDiffEntry> SummaryDiff::entries() const
+{
+    QQmlListProperty<SummaryDiffEntry> prop(const_cast<SummaryDiff *>(this),
+                                            &const_cast<SummaryDiff *>(this)->m_entries);
+    prop.append = nullptr;
+    prop.clear = nullptr;
+    prop.replace = nullptr;
+    prop.removeLast = nullptr;
+    return prop;
+}
+
+int SummaryDiff::regressionCount() const
+{
+    return int(std::count_if(m_entries.begin(), m_entries.end(), [](const SummaryDiffEntry *entry) {
+        return entry->regression();
+    }));
+}
+
+QString SummaryDiff::report() const
+{
+    QString result;
+    for (const SummaryDiffEntry *entry : m_entries) {
+        const auto verdict = entry->regression()    ? QStringLiteral("REGRESSION")
+                             : !entry->significant() ? QString()
+                             : entry->change() > 0   ? QStringLiteral("slower")
+                                                     : QStringLiteral("faster");
+        result += QStringLiteral("%1 %2% %3 mean %4 -> %5, p50 %6 -> %7, p90 %8 -> %9 (n %10 -> %11)  %12\n")
+                      .arg(verdict, -10)
+                      .arg(entry->change() * 100, 7, 'f', 1)
+                      .arg(entry->metric(), -13)
+                      .arg(formatTime(entry->baselineMean()),
+                           formatTime(entry->candidateMean()),
+                           formatTime(entry->baselineP50()),
+                           formatTime(entry->candidateP50()),
+                           formatTime(entry->baselineP90()),
+                           formatTime(entry->candidateP90()))
+                      .arg(entry->baselineCount())
+                      .arg(entry->candidateCount())
+                      .arg(entry->location());
+    }
+    for (const auto &location : m_addedLocations) {
+        result += QStringLiteral("added: %1\n").arg(location);
+    }
+    for (const auto &location : m_removedLocations) {
+        result += QStringLiteral("removed: %1\n").arg(location);
+    }
+    result += QStringLiteral("%1 regression(s) above +%2%\n")
+                  .arg(regressionCount())
+                  .arg(m_threshold * 100, 0, 'f', 1);
+    return result;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "meandiff.h"
+#include "summary.h"
+
+#include <QObject>
+#include <QQmlListProperty>
+#include <QStringList>
+#include <QtQmlIntegration>
+
+/**
+ * @brief The SummaryDiffEntry class - change of one metric of one location between two summaries.
+ * The change is measured on the exact means, the bucketed quantiles are too coarse to see shifts
+ * within a bucket. Whether it is significant is decided by `MeanDiff`.
+ */
+class SummaryDiffEntry : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created by SummaryDiff only")
+
+    Q_PROPERTY(QString location MEMBER m_location CONSTANT)
+    Q_PROPERTY(QString metric MEMBER m_metric CONSTANT)
+    Q_PROPERTY(quint64 baselineCount READ baselineCount CONSTANT)
+    Q_PROPERTY(quint64 candidateCount READ candidateCount CONSTANT)
+    Q_PROPERTY(double baselineMean READ baselineMean CONSTANT)
+    Q_PROPERTY(double candidateMean READ candidateMean CONSTANT)
+    Q_PROPERTY(double baselineP50 READ baselineP50 CONSTANT)
+    Q_PROPERTY(double candidateP50 READ candidateP50 CONSTANT)
+    Q_PROPERTY(double baselineP90 READ baselineP90 CONSTANT)
+    Q_PROPERTY(double candidateP90 READ candidateP90 CONSTANT)
+    Q_PROPERTY(double change READ change CONSTANT)
+    Q_PROPERTY(bool significant READ significant CONSTANT)
+    Q_PROPERTY(bool regression READ regression CONSTANT)
+public:
+    SummaryDiffEntry(const QString &location,
+                     const QString &metric,
+                     const Summary::Distribution &baseline,
+                     const Summary::Distribution &candidate,
+                     double threshold,
+                     QObject *parent = nullptr);
+
+    QString location() const { return m_location; }
+    QString metric() const { return m_metric; }
+    quint64 baselineCount() const { return m_baseline.count; }
+    quint64 candidateCount() const { return m_candidate.count; }
+    double baselineMean() const { return m_baseline.mean(); }
+    double candidateMean() const { return m_candidate.mean(); }
+    double baselineP50() const { return m_baseline.p50; }
+    double candidateP50() const { return m_candidate.p50; }
+    double baselineP90() const { return m_baseline.p90; }
+    double candidateP90() const { return m_candidate.p90; }
+
+    const MeanDiff &diff() const { return m_diff; }
+    double change() const { return m_diff.change; }
+    bool significant() const { return m_diff.significant; }
+    bool regression() const { return m_diff.regression(m_threshold); }
+
+private:
+    QString m_location;
+    QString m_metric;
+    Summary::Distribution m_baseline;
+    Summary::Distribution m_candidate;
+    MeanDiff m_diff;
+    double m_threshold;
+};
+
+/**
+ * @brief The SummaryDiff class - metrics of the locations present in both summaries ranked by
+ * `MeanDiff::ranksBefore`, for `--compare`
+ */
+class SummaryDiff : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("created from the command line only")
+
+    Q_PROPERTY(QQmlListProperty<SummaryDiffEntry> entries READ entries CONSTANT)
+    Q_PROPERTY(QStringList addedLocations MEMBER m_addedLocations CONSTANT)
+    Q_PROPERTY(QStringList removedLocations MEMBER m_removedLocations CONSTANT)
+    Q_PROPERTY(double threshold MEMBER m_threshold CONSTANT)
+    Q_PROPERTY(int regressionCount READ regressionCount CONSTANT)
+public:
+    SummaryDiff(const Summary &baseline,
+                const Summary &candidate,
+                double threshold,
+                QObject *parent = nullptr);
+
+    QQmlListProperty<SummaryDiffEntry> entries() const;
+    const QList<SummaryDiffEntry *> &entryList() const { return m_entries; }
+    int regressionCount() const;
+
+    /**
+     * @brief report - plain text table of the entries, for headless runs
+     */
+    QString report() const;
+
+private:
+    QList<SummaryDiffEntry *> m_entries;
+    QStringList m_addedLocations;
+    QStringList m_removedLocations;
+    double m_threshold;
+};
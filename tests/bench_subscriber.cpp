@@ -0,0 +1,63 @@
+#include "eventpolicy.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief The EmptySubscriber class - same baseline as `--subscriber empty`
+ */
+class EmptySubscriber : public coschedula::scheduler::subscriber
+{
+public:
+    void task_started(const coschedula::scheduler::task_info &) override {}
+    void task_finished(const coschedula::scheduler::task_info &) override {}
+    void task_suspended(const coschedula::scheduler::task_info &) override {}
+    void task_resumed(const coschedula::scheduler::task_info &) override {}
+};
+
+constexpr std::uint64_t Rounds = 10 * 1000 * 1000;
+
+/**
+ * @brief nsPerEvent - dispatch a started/suspended/resumed/finished sequence `Rounds` times
+ * through the subscriber interface, as the scheduler does, and return the cost per event
+ */
+double nsPerEvent(coschedula::scheduler::subscriber *subscriber)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const coschedula::scheduler::task_info info{};
+    // keeps the compiler from seeing through the virtual calls
+    coschedula::scheduler::subscriber *volatile target = subscriber;
+
+    const auto start = Clock::now();
+    for (std::uint64_t i = 0; i < Rounds; ++i) {
+        if (coschedula::scheduler::subscriber *const s = target) {
+            s->task_started(info);
+            s->task_suspended(info);
+            s->task_resumed(info);
+            s->task_finished(info);
+        }
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / double(Rounds * 4);
+}
+
+} // namespace
+
+/**
+ * Cost of the subscriber alone, without the scheduler and workload around it: `none` is the loop
+ * without any subscriber, `empty` the virtual calls, `counters` `MonitorImpl` with `CountersPolicy`.
+ */
+int main()
+{
+    EmptySubscriber empty;
+    MonitorImpl<coschedula::scheduler, CountersPolicy> counters;
+
+    std::printf("none:     %.2f ns/event\n", nsPerEvent(nullptr));
+    std::printf("empty:    %.2f ns/event\n", nsPerEvent(&empty));
+    std::printf("counters: %.2f ns/event\n", nsPerEvent(&counters));
+    return counters.count(EventKind::Finished) == Rounds ? 0 : 1;
+}
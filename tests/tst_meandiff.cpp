@@ -0,0 +1,111 @@
+#include "meandiff.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            return false;                                                                \
+        }                                                                                \
+    } while (false)
+
+constexpr double Threshold = 0.1;
+
+/**
+ * @brief significance - the z-score decides, not the size of the change
+ */
+bool significance()
+{
+    // +50% but within the noise of both runs: z = 50 / sqrt(2 * 100^2 / 10) ~ 1.1
+    const auto noisy = MeanDiff::compare({10, 100, 100}, {10, 150, 100});
+    CHECK(noisy.change == 0.5);
+    CHECK(!noisy.significant);
+    CHECK(!noisy.regression(Threshold));
+
+    // +5% with a tight spread: z = 5 / sqrt(2 * 1^2 / 100) ~ 35
+    const auto small = MeanDiff::compare({100, 100, 1}, {100, 105, 1});
+    CHECK(small.significant);
+    CHECK(small.zScore > 30);
+    // significant but below the threshold
+    CHECK(!small.regression(Threshold));
+    CHECK(small.regression(0.04));
+
+    // just around MinZScore: se = sqrt(2 * 10^2 / 50) = 2
+    CHECK(MeanDiff::compare({50, 100, 10}, {50, 106, 10}).significant);
+    CHECK(!MeanDiff::compare({50, 100, 10}, {50, 105.9, 10}).significant);
+
+    // improvements are significant, never regressions
+    const auto faster = MeanDiff::compare({100, 100, 1}, {100, 50, 1});
+    CHECK(faster.significant);
+    CHECK(faster.zScore < 0);
+    CHECK(!faster.regression(Threshold));
+    return true;
+}
+
+/**
+ * @brief edgeCases - too few samples, no spread, empty baseline
+ */
+bool edgeCases()
+{
+    const auto few = MeanDiff::compare({MeanDiff::MinSamples - 1, 100, 0}, {100, 200, 0});
+    CHECK(few.change == 1);
+    CHECK(!few.significant);
+    CHECK(few.zScore == 0);
+
+    // no spread at all, e.g. fixed busy work: any difference is real
+    const auto exact = MeanDiff::compare({5, 100, 0}, {5, 120, 0});
+    CHECK(exact.significant);
+    CHECK(exact.regression(Threshold));
+    CHECK(!MeanDiff::compare({5, 100, 0}, {5, 100, 0}).significant);
+
+    // nothing to relate the change to
+    const auto empty = MeanDiff::compare({5, 0, 0}, {5, 10, 1});
+    CHECK(empty.change == 0);
+    CHECK(empty.significant);
+    CHECK(!empty.regression(Threshold));
+    return true;
+}
+
+/**
+ * @brief ranking - a significant regression ranks above a larger change within the noise
+ */
+bool ranking()
+{
+    std::vector<MeanDiff> diffs{
+        MeanDiff::compare({10, 100, 300}, {10, 300, 300}),  // +200%, noise
+        MeanDiff::compare({100, 100, 1}, {100, 80, 1}),     // -20%, significant
+        MeanDiff::compare({100, 100, 1}, {100, 120, 1}),    // +20%, significant
+        MeanDiff::compare({10, 100, 100}, {10, 10, 100}),   // -90%, noise
+        MeanDiff::compare({100, 100, 1}, {100, 105, 1}),    // +5%, significant
+    };
+    std::stable_sort(diffs.begin(), diffs.end(), MeanDiff::ranksBefore);
+
+    std::vector<double> changes;
+    for (const auto &diff : diffs) {
+        changes.push_back(diff.change);
+    }
+    const std::vector<double> expected{0.2, 0.05, -0.2, 2, -0.9};
+    CHECK(changes.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        CHECK(std::abs(changes[i] - expected[i]) < 1e-9);
+    }
+    CHECK(diffs[0].regression(Threshold));
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = significance();
+    ok = edgeCases() && ok;
+    ok = ranking() && ok;
+    std::puts(ok ? "meandiff: ok" : "meandiff: FAILED");
+    return ok ? 0 : 1;
+}
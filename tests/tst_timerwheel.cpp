@@ -0,0 +1,135 @@
+#include "timerwheel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            return false;                                                                \
+        }                                                                                \
+    } while (false)
+
+struct Item
+{
+    std::size_t id;
+};
+
+// two levels of four slots span 16 ticks, so most deadlines cascade and many are clamped
+using Wheel = TimerWheel<Item, 2, 2>;
+
+constexpr std::uint64_t Tick = 10;
+
+std::uint64_t ceilTick(std::uint64_t deadline)
+{
+    return (deadline + Tick - 1) / Tick;
+}
+
+/**
+ * @brief randomized - schedule, cancel and reschedule (also from inside `advance`) against a
+ * reference of expected expiry ticks: nothing may expire early or late
+ */
+bool randomized(std::uint64_t seed)
+{
+    std::mt19937_64 random(seed);
+    const auto below = [&random](std::uint64_t n) { return std::uint64_t(random() % n); };
+
+    constexpr std::size_t Count = 64;
+    std::vector<Item> items(Count);
+    std::vector<std::unique_ptr<Wheel::Entry>> entries;
+    for (std::size_t i = 0; i < Count; ++i) {
+        items[i].id = i;
+        entries.push_back(std::make_unique<Wheel::Entry>(&items[i]));
+    }
+
+    Wheel wheel(Tick);
+    std::uint64_t now = 0;
+    // id -> tick at which the entry has to expire
+    std::map<std::size_t, std::uint64_t> expected;
+
+    for (int step = 0; step < 2000; ++step) {
+        for (auto n = below(4); n > 0; --n) {
+            const auto id = below(Count);
+            if (below(5) == 0) {
+                wheel.cancel(*entries[id]);
+                expected.erase(id);
+                CHECK(!entries[id]->scheduled());
+                continue;
+            }
+            // up to far past the wheel span, sometimes already due
+            const auto deadline = below(3) == 0 ? now - std::min(now, below(50))
+                                                : now + below(Tick * 100);
+            wheel.schedule(*entries[id], deadline);
+            expected[id] = std::max(ceilTick(deadline), now / Tick + 1);
+        }
+        CHECK(wheel.size() == expected.size());
+
+        const auto target = now + below(Tick * 30);
+        std::map<std::size_t, std::uint64_t> rescheduled;
+        bool ok = true;
+        wheel.advance(target, [&](Wheel::Entry &entry) {
+            const auto id = entry.value()->id;
+            const auto it = expected.find(id);
+            if (it == expected.end() || it->second > target / Tick) {
+                std::fprintf(stderr, "entry %zu expired early or unexpectedly\n", id);
+                ok = false;
+                return;
+            }
+            expected.erase(it);
+            if (below(3) == 0) {
+                // past the target, so it cannot expire within this advance
+                const auto deadline = (target / Tick + 1) * Tick + below(Tick * 100);
+                wheel.schedule(entry, deadline);
+                rescheduled[id] = ceilTick(deadline);
+            }
+        });
+        CHECK(ok);
+        for (const auto &[id, tick] : expected) {
+            // late: due by the target but still scheduled
+            CHECK(tick > target / Tick);
+        }
+        expected.merge(rescheduled);
+        now = target;
+        CHECK(wheel.size() == expected.size());
+    }
+    return true;
+}
+
+/**
+ * @brief farDeadline - a deadline many wheel spans away is clamped and re-cascaded until it is due
+ */
+bool farDeadline()
+{
+    Item item{0};
+    Wheel::Entry entry(&item);
+    Wheel wheel(Tick);
+
+    wheel.schedule(entry, 1000 * Tick);
+    std::uint64_t expiredAt = 0;
+    for (std::uint64_t now = Tick; now <= 1100 * Tick; now += Tick) {
+        wheel.advance(now, [&](Wheel::Entry &) { expiredAt = now; });
+    }
+    CHECK(expiredAt == 1000 * Tick);
+    CHECK(wheel.size() == 0);
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = farDeadline();
+    for (std::uint64_t seed = 0; seed < 50; ++seed) {
+        ok = randomized(seed) && ok;
+    }
+    std::puts(ok ? "timerwheel: ok" : "timerwheel: FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The TimerWheel class - hierarchical timer wheel over intrusive entries.
+ * `schedule` and `cancel` are O(1). `advance` processes one slot per elapsed tick and
+ * cascades an upper level slot into the lower ones once per revolution of the level below,
+ * so the cost is amortized over the elapsed time instead of the number of timers.
+ * Deadlines farther than the wheel span are parked in the last level and re-cascaded.
+ */
+template<typename T, std::size_t SlotBits = 8, std::size_t Levels = 4>
+class TimerWheel
+{
+public:
+    class Entry
+    {
+        friend TimerWheel;
+
+    public:
+        explicit Entry(T *value)
+            : m_value(value)
+        {}
+
+        Entry(const Entry &) = delete;
+        Entry &operator=(const Entry &) = delete;
+
+        T *value() const { return m_value; }
+        bool scheduled() const { return m_prev != nullptr; }
+        std::uint64_t deadline() const { return m_deadline; }
+
+    private:
+        T *m_value;
+        Entry *m_prev = nullptr;
+        Entry *m_next = nullptr;
+        std::uint64_t m_deadline = 0;
+    };
+
+    explicit TimerWheel(std::uint64_t tick, std::uint64_t now = 0)
+        : m_tick(tick)
+        , m_now(now / tick)
+    {
+        assert(tick > 0);
+        for (auto &level : m_slots) {
+            for (auto &slot : level) {
+                slot.m_prev = &slot;
+                slot.m_next = &slot;
+            }
+        }
+    }
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    std::size_t size() const { return m_size; }
+
+    /**
+     * @brief schedule - (re)schedule `entry` to expire at `deadline` (same units as `tick`)
+     */
+    void schedule(Entry &entry, std::uint64_t deadline)
+    {
+        cancel(entry);
+        entry.m_deadline = deadline;
+        // entries already due go into the next slot to be processed
+        insert(entry, m_now + 1);
+        ++m_size;
+    }
+
+    void cancel(Entry &entry)
+    {
+        if (!entry.scheduled())
+            return;
+
+        unlink(entry);
+        --m_size;
+    }
+
+    /**
+     * @brief advance - move the wheel to `now` and call `expired(Entry &)` for every entry due by then.
+     * The entry is unscheduled before the call and may be rescheduled from it.
+     */
+    template<typename F>
+    void advance(std::uint64_t now, F &&expired)
+    {
+        const auto target = now / m_tick;
+        while (m_now < target) {
+            if (m_size == 0) {
+                m_now = target;
+                return;
+            }
+
+            ++m_now;
+            for (std::size_t level = Levels - 1; level > 0; --level) {
+                if ((m_now & mask(level)) == 0) {
+                    cascade(m_slots[level][slotIndex(m_now, level)]);
+                }
+            }
+
+            Entry &head = m_slots[0][slotIndex(m_now, 0)];
+            while (head.m_next != &head) {
+                Entry &entry = *head.m_next;
+                cancel(entry);
+                expired(entry);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t SlotCount = std::size_t(1) << SlotBits;
+
+    static constexpr std::uint64_t mask(std::size_t level)
+    {
+        return (std::uint64_t(1) << (SlotBits * level)) - 1;
+    }
+
+    static constexpr std::size_t slotIndex(std::uint64_t tick, std::size_t level)
+    {
+        return (tick >> (SlotBits * level)) & (SlotCount - 1);
+    }
+
+    void insert(Entry &entry, std::uint64_t earliest)
+    {
+        const auto deadline = std::max((entry.m_deadline + m_tick - 1) / m_tick, earliest);
+        const auto delta = deadline - m_now;
+
+        std::size_t level = 0;
+        while (level < Levels - 1 && delta > mask(level + 1)) {
+            ++level;
+        }
+
+        // clamp to the farthest slot of the last level, it is re-cascaded on the way
+        const auto tick = delta > mask(Levels) ? m_now + mask(Levels) : deadline;
+        link(m_slots[level][slotIndex(tick, level)], entry);
+    }
+
+    void cascade(Entry &head)
+    {
+        if (head.m_next == &head)
+            return;
+
+        Head list;
+
+        // detach the whole slot first since entries may be reinserted into it
+        list.m_next = head.m_next;
+        list.m_prev = head.m_prev;
+        list.m_next->m_prev = &list;
+        list.m_prev->m_next = &list;
+        head.m_next = &head;
+        head.m_prev = &head;
+
+        while (list.m_next != &list) {
+            Entry &entry = *list.m_next;
+            unlink(entry);
+            // the current level 0 slot is processed right after cascading
+            insert(entry, m_now);
+        }
+    }
+
+    static void link(Entry &head, Entry &entry)
+    {
+        entry.m_prev = head.m_prev;
+        entry.m_next = &head;
+        head.m_prev->m_next = &entry;
+        head.m_prev = &entry;
+    }
+
+    static void unlink(Entry &entry)
+    {
+        entry.m_prev->m_next = entry.m_next;
+        entry.m_next->m_prev = entry.m_prev;
+        entry.m_prev = nullptr;
+        entry.m_next = nullptr;
+    }
+
+private:
+    struct Head : Entry
+    {
+        Head()
+            : Entry(nullptr)
+        {}
+    };
+
+    std::uint64_t m_tick;
+    std::uint64_t m_now;
+    std::size_t m_size = 0;
+    std::array<std::array<Head, SlotCount>, Levels> m_slots;
+};
@@ -0,0 +1,207 @@
+#include "workload.h"
+#include "duration.h"
+#include "monitoredfs.h"
+
+namespace {
+
+std::optional<std::size_t> parseCount(const QString &str)
+{
+    bool ok = false;
+    const auto value = str.toULongLong(&ok);
+    if (!ok)
+        return std::nullopt;
+    return value;
+}
+
+} // namespace
+
+std::optional<Workload::Distribution> Workload::Distribution::parse(const QString &spec)
+{
+    const auto parts = spec.split(QLatin1Char(':'));
+    if (parts.size() == 2 && parts[0] == QStringLiteral("fixed")) {
+        if (const auto d = parseDuration(parts[1]))
+            return Distribution{Kind::Fixed, *d, *d};
+    } else if (parts.size() == 3 && parts[0] == QStringLiteral("uniform")) {
+        const auto min = parseDuration(parts[1]);
+        const auto max = parseDuration(parts[2]);
+        if (min && max && *min <= *max)
+            return Distribution{Kind::Uniform, *min, *max};
+    } else if (parts.size() == 2 && parts[0] == QStringLiteral("exp")) {
+        if (const auto d = parseDuration(parts[1]))
+            return Distribution{Kind::Exponential, *d, *d};
+    }
+    return std::nullopt;
+}
+
+std::size_t Workload::Options::taskCount() const
+{
+    std::size_t level = roots;
+    std::size_t count = 0;
+    for (std::size_t d = 0; d <= depth; ++d) {
+        count += level;
+        level *= fanOut;
+    }
+    return count;
+}
+
+void Workload::addOptions(QCommandLineParser &parser)
+{
+    parser.addOptions({
+        {QStringLiteral("roots"), QStringLiteral("Number of root tasks."), QStringLiteral("n"), QStringLiteral("1")},
+        {QStringLiteral("fan-out"),
+         QStringLiteral("Children spawned and awaited by every non-leaf task."),
+         QStringLiteral("n"),
+         QStringLiteral("1")},
+        {QStringLiteral("depth"), QStringLiteral("Await depth below the roots."), QStringLiteral("n"), QStringLiteral("1")},
+        {QStringLiteral("suspends"), QStringLiteral("Suspends per task."), QStringLiteral("n"), QStringLiteral("4")},
+        {QStringLiteral("work"),
+         QStringLiteral("Simulated work after every resume: fixed:<d>, uniform:<min>:<max> or exp:<mean>, "
+                        "where <d> is e.g. 500ns, 20us, 1.5ms."),
+         QStringLiteral("distribution"),
+         QStringLiteral("fixed:0ns")},
+        {QStringLiteral("io-file"),
+         QStringLiteral("Local file read by leaf tasks, may be repeated."),
+         QStringLiteral("path")},
+        {QStringLiteral("io-bytes"),
+         QStringLiteral("Size of a generated temp file read by leaf tasks, 0 disables it."),
+         QStringLiteral("bytes"),
+         QStringLiteral("0")},
+        {QStringLiteral("seed"), QStringLiteral("Seed of the work duration generator."), QStringLiteral("n"), QStringLiteral("0")},
+    });
+}
+
+std::optional<Workload::Options> Workload::parseOptions(const QCommandLineParser &parser, QString *error)
+{
+    Options result;
+    const auto count = [&](const QString &name, std::size_t &out) {
+        const auto value = parseCount(parser.value(name));
+        if (!value) {
+            *error = QStringLiteral("invalid --%1: %2").arg(name, parser.value(name));
+            return false;
+        }
+        out = *value;
+        return true;
+    };
+
+    std::size_t seed = 0;
+    if (!count(QStringLiteral("roots"), result.roots) || !count(QStringLiteral("fan-out"), result.fanOut)
+        || !count(QStringLiteral("depth"), result.depth)
+        || !count(QStringLiteral("suspends"), result.suspends)
+        || !count(QStringLiteral("io-bytes"), result.ioBytes) || !count(QStringLiteral("seed"), seed)) {
+        return std::nullopt;
+    }
+    result.seed = seed;
+
+    const auto work = Distribution::parse(parser.value(QStringLiteral("work")));
+    if (!work) {
+        *error = QStringLiteral("invalid --work: %1").arg(parser.value(QStringLiteral("work")));
+        return std::nullopt;
+    }
+    result.work = *work;
+    result.ioFiles = parser.values(QStringLiteral("io-file"));
+    return result;
+}
+
+Workload::Workload(Monitor *monitor, Options options)
+    : m_monitor(monitor)
+    , m_options(std::move(options))
+    , m_random(m_options.seed)
+{}
+
+bool Workload::prepare()
+{
+    for (const auto &file : std::as_const(m_options.ioFiles)) {
+        m_files.push_back(file.toStdString());
+    }
+
+    if (m_options.ioBytes > 0) {
+        m_tempFile = std::make_unique<QTemporaryFile>();
+        if (!m_tempFile->open())
+            return false;
+
+        const QByteArray chunk(64 * 1024, 'x');
+        for (std::size_t written = 0; written < m_options.ioBytes;) {
+            const auto size = std::min<std::size_t>(chunk.size(), m_options.ioBytes - written);
+            if (m_tempFile->write(chunk.constData(), size) != qint64(size))
+                return false;
+            written += size;
+        }
+        m_tempFile->close();
+        m_files.push_back(m_tempFile->fileName().toStdString());
+    }
+    return true;
+}
+
+void Workload::start()
+{
+    m_roots.reserve(m_options.roots);
+    for (std::size_t i = 0; i < m_options.roots; ++i) {
+        m_roots.push_back(node(0));
+    }
+}
+
+Workload::Task Workload::node(std::size_t depth)
+{
+    std::vector<Task> children;
+    if (depth < m_options.depth) {
+        children.reserve(m_options.fanOut);
+        for (std::size_t i = 0; i < m_options.fanOut; ++i) {
+            children.push_back(node(depth + 1));
+        }
+    }
+
+    std::optional<coschedula::task<std::string, coschedula::scheduler>> read;
+    if (children.empty() && !m_files.empty()) {
+        const auto &path = m_files[m_nextFile++ % m_files.size()];
+        if (m_monitor) {
+            read = monitored::fs::read<std::string::value_type, coschedula::execution::par>(
+                *m_monitor, path);
+        } else {
+            read = coschedula::fs::read<std::string::value_type, coschedula::execution::par>(path);
+        }
+    }
+
+    for (std::size_t i = 0; i < m_options.suspends; ++i) {
+        co_await coschedula::suspend{};
+        work();
+    }
+
+    std::size_t count = 1;
+    for (const auto &child : children) {
+        count += co_await child;
+    }
+    if (read) {
+        co_await *read;
+    }
+    co_return count;
+}
+
+void Workload::work()
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::nanoseconds duration{0};
+    switch (m_options.work.kind) {
+    case Distribution::Kind::Fixed:
+        duration = m_options.work.a;
+        break;
+    case Distribution::Kind::Uniform:
+        duration = std::chrono::nanoseconds(
+            std::uniform_int_distribution<std::int64_t>(m_options.work.a.count(),
+                                                        m_options.work.b.count())(m_random));
+        break;
+    case Distribution::Kind::Exponential:
+        if (m_options.work.a.count() > 0) {
+            duration = std::chrono::nanoseconds(static_cast<std::int64_t>(
+                std::exponential_distribution<double>(1.0 / m_options.work.a.count())(m_random)));
+        }
+        break;
+    }
+
+    if (duration.count() == 0)
+        return;
+
+    const auto deadline = Clock::now() + duration;
+    while (Clock::now() < deadline) {
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QCommandLineParser>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <chrono>
+#include <coschedula/task.h>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+class Monitor;
+
+/**
+ * @brief The Workload class - synthetic tree of coroutines used to scale the monitor.
+ * Each of `roots` root tasks spawns `fanOut` children down to `depth` levels and awaits them.
+ * Every task suspends `suspends` times and busy-waits a duration drawn from `work` after each resume.
+ * Leaves optionally read local files, through `monitored::fs::read` if there is a monitor.
+ */
+class Workload
+{
+public:
+    struct Distribution
+    {
+        enum class Kind { Fixed, Uniform, Exponential };
+
+        Kind kind = Kind::Fixed;
+        std::chrono::nanoseconds a{0};
+        std::chrono::nanoseconds b{0};
+
+        /**
+         * @brief parse - `fixed:<d>`, `uniform:<min>:<max>` or `exp:<mean>`, e.g. `uniform:5us:20us`
+         */
+        static std::optional<Distribution> parse(const QString &spec);
+    };
+
+    struct Options
+    {
+        std::size_t roots = 1;
+        std::size_t fanOut = 1;
+        std::size_t depth = 1;
+        std::size_t suspends = 4;
+        Distribution work;
+        QStringList ioFiles;
+        std::size_t ioBytes = 0;
+        std::uint64_t seed = 0;
+
+        /**
+         * @brief taskCount - number of coroutines the workload creates, not counting reads
+         */
+        std::size_t taskCount() const;
+    };
+
+    static void addOptions(QCommandLineParser &parser);
+    static std::optional<Options> parseOptions(const QCommandLineParser &parser, QString *error);
+
+    /**
+     * @brief Workload
+     * @param monitor - receives I/O instrumentation, may be null if the Qt model is not used
+     */
+    Workload(Monitor *monitor, Options options);
+
+    const Options &options() const { return m_options; }
+
+    /**
+     * @brief prepare - collect the files to read and write the `ioBytes` temp file, kept out of
+     * `start` so timing the workload does not time the file generation
+     * @return false if the temp file could not be written
+     */
+    bool prepare();
+
+    /**
+     * @brief start - create the root tasks, after `prepare`
+     */
+    void start();
+
+private:
+    using Task = coschedula::task<std::size_t, coschedula::scheduler>;
+
+    Task node(std::size_t depth);
+    void work();
+
+private:
+    Monitor *m_monitor;
+    Options m_options;
+    std::mt19937_64 m_random;
+    std::unique_ptr<QTemporaryFile> m_tempFile;
+    std::vector<std::string> m_files;
+    std::size_t m_nextFile = 0;
+    std::vector<Task> m_roots;
+};